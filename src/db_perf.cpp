@@ -0,0 +1,789 @@
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <new>
+#include <random>
+#include <thread>
+
+#include "snackis/ctx.hpp"
+#include "snackis/snackis.hpp"
+#include "snackis/core/fmt.hpp"
+#include "snackis/core/int64_type.hpp"
+#include "snackis/core/set_type.hpp"
+#include "snackis/core/str_type.hpp"
+#include "snackis/core/stream.hpp"
+#include "snackis/core/time.hpp"
+#include "snackis/core/time_type.hpp"
+#include "snackis/core/uid_type.hpp"
+#include "snackis/db/col.hpp"
+#include "snackis/db/ctx.hpp"
+#include "snackis/db/key.hpp"
+#include "snackis/db/proc.hpp"
+#include "snackis/db/schema.hpp"
+#include "snackis/db/table.hpp"
+
+using namespace snackis;
+using namespace snackis::db;
+
+static thread_local int64_t alloc_count(0);
+
+void *operator new(size_t size) {
+  alloc_count++;
+  auto p(malloc(size ? size : 1));
+  if (!p) { abort(); }
+  return p;
+}
+
+void operator delete(void *p) noexcept {
+  free(p);
+}
+
+struct Foo {
+  UId id;
+  int64_t fint64;
+  str fstr;
+  Time ftime;
+  std::set<str> fset;
+  Foo(): id(true), fint64(0), ftime(now()) { }
+};
+
+const Col<Foo, UId> id_col("id", uid_type, &Foo::id);
+const Col<Foo, int64_t> int64_col("int64", int64_type, &Foo::fint64);
+const Col<Foo, str> str_col("str", str_type, &Foo::fstr);
+const Col<Foo, Time> time_col("time", time_type, &Foo::ftime);
+const Col<Foo, std::set<str>> set_col("set", str_set_type, &Foo::fset);
+
+const Schema<Foo> foo_cols({&id_col, &int64_col, &str_col, &time_col, &set_col});
+const Key<Foo, UId> foo_key(id_col);
+
+/* Previous map-based layout, kept here as baseline */
+
+using MapRec = std::map<const BasicCol<Foo> *, Val>;
+
+static void map_copy(MapRec &dest, const Foo &src) {
+  for (auto c: foo_cols.cols) { dest[c] = c->get(src); }
+}
+
+static int map_compare(const MapRec &x, const MapRec &y) {
+  for (auto c: foo_cols.cols) {
+    auto xi = x.find(c);
+    auto yi = y.find(c);
+
+    if (xi == x.end() && yi == y.end()) { continue; }
+    if (xi == x.end()) { return 1; }
+    if (yi == y.end()) { return -1; }
+
+    if (*xi < *yi) { return -1; }
+    if (*yi < *xi) { return 1; }
+  }
+
+  return 0;
+}
+
+static void map_read(std::istream &in, MapRec &rec) {
+  int64_t cnt(int64_type.read(in));
+
+  for (int64_t i=0; i<cnt; i++) {
+    const str cname(str_type.read(in));
+    auto found(foo_cols.col_lookup.find(cname));
+
+    if (found != foo_cols.col_lookup.end()) {
+      auto c = found->second;
+      rec[c] = c->read(in);
+    }
+  }
+}
+
+const int64_t MAX_RECS(100000);
+
+static std::vector<Foo> init_foos() {
+  std::vector<Foo> out(MAX_RECS);
+
+  for (int64_t i(0); i < MAX_RECS; i++) {
+    auto &foo(out[i]);
+    foo.fint64 = i;
+    foo.fstr = fmt("foo %0", i);
+    foo.fset.insert("bar");
+    foo.fset.insert("baz");
+  }
+
+  return out;
+}
+
+enum Format {FORMAT_TEXT, FORMAT_CSV, FORMAT_JSON};
+
+struct Result {
+  str id;
+  int64_t val;
+  str unit;
+};
+
+static Format format(FORMAT_TEXT);
+static std::vector<Result> results;
+
+static void report(const str &id, int64_t val, const str &unit) {
+  results.push_back({id, val, unit});
+  if (format == FORMAT_TEXT) { std::cout << fmt("%0: %1 %2", id, val, unit) << std::endl; }
+}
+
+static void print_results() {
+  if (format == FORMAT_CSV) {
+    std::cout << "version,id,value,unit" << std::endl;
+
+    for (auto &r: results) {
+      std::cout << fmt("%0,%1,%2,%3", version_str(), r.id, r.val, r.unit) << std::endl;
+    }
+  } else if (format == FORMAT_JSON) {
+    std::cout << fmt("{\"version\": \"%0\", \"results\": [", version_str());
+    
+    for (size_t i(0); i < results.size(); i++) {
+      auto &r(results[i]);
+      std::cout << fmt("%0\n  {\"id\": \"%1\", \"value\": %2, \"unit\": \"%3\"}",
+		       i ? "," : "", r.id, r.val, r.unit);
+    }
+
+    std::cout << "\n]}" << std::endl;
+  }
+}
+
+template <typename FnT>
+static void run(const str &id, const FnT &fn) {
+  auto start(pnow());
+  fn();
+  report(id, usecs(pnow()-start), "us");
+}
+
+template <typename FnT>
+static void run_allocs(const str &id, int64_t cnt, const str &per, const FnT &fn) {
+  const int64_t start_allocs(alloc_count);
+  auto start(pnow());
+  fn();
+  const int64_t allocs(alloc_count-start_allocs), time(usecs(pnow()-start));
+  report(id, time, "us");
+  report(fmt("%0 allocs", id), allocs / cnt, fmt("allocs/%0", per));
+}
+
+static void rec_perf() {
+  auto foos(init_foos());
+  Stream buf;
+
+  for (auto &foo: foos) {
+    write(db::Rec<Foo>(foo_cols, foo), buf, nullopt);
+  }
+
+  const str data(buf.str());
+
+  run("rec slurp map", [&data]() {
+      InStream in(data);
+      std::map<UId, MapRec> recs;
+
+      for (int64_t i(0); i < MAX_RECS; i++) {
+	MapRec rec;
+	map_read(in, rec);
+	recs.emplace(get<UId>(rec[&id_col]), rec);
+      }
+    });
+
+  run("rec slurp slots", [&data]() {
+      InStream in(data);
+      std::map<UId, db::Rec<Foo>> recs;
+
+      for (int64_t i(0); i < MAX_RECS; i++) {
+	db::Rec<Foo> rec;
+	read(foo_cols, in, rec, nullopt);
+	recs.emplace(std::get<0>(foo_key(rec)), rec);
+      }
+    });
+
+  run("rec update map", [&foos]() {
+      for (auto &foo: foos) {
+	MapRec prev, curr;
+	map_copy(prev, foo);
+	foo.fint64++;
+	map_copy(curr, foo);
+	CHECK(map_compare(prev, curr), _ != 0);
+      }
+    });
+
+  run("rec update slots", [&foos]() {
+      for (auto &foo: foos) {
+	db::Rec<Foo> prev(foo_cols, foo);
+	foo.fint64++;
+	db::Rec<Foo> curr(foo_cols, foo);
+	CHECK(compare(foo_cols, prev, curr), _ != 0);
+      }
+    });
+}
+
+static void enc_perf(Int64Enc enc, const str &id) {
+  auto foos(init_foos());
+  Stream buf;
+  set_int64_enc(buf, enc);
+  
+  run(fmt("enc write %0", id), [&foos, &buf]() {
+      for (auto &foo: foos) {
+	write(db::Rec<Foo>(foo_cols, foo), buf, nullopt);
+      }
+    });
+
+  const str data(buf.str());
+  report(fmt("enc size %0", id), data.size(), "bytes");
+  
+  run(fmt("enc read %0", id), [&data, enc]() {
+      InStream in(data);
+      set_int64_enc(in, enc);
+      
+      for (int64_t i(0); i < MAX_RECS; i++) {
+	db::Rec<Foo> rec;
+	read(foo_cols, in, rec, nullopt);
+      }
+    });
+}
+
+static void cols_perf() {
+  auto foos(init_foos());
+  Stream names_buf, ords_buf;
+
+  for (auto &foo: foos) {
+    const db::Rec<Foo> rec(foo_cols, foo);
+    write(rec, names_buf, nullopt);
+    write_ords(rec, ords_buf, nullopt);
+  }
+  
+  const str names_data(names_buf.str()), ords_data(ords_buf.str());
+  report("cols size names", names_data.size(), "bytes");
+  report("cols size ords", ords_data.size(), "bytes");
+
+  run("cols read names", [&names_data]() {
+      InStream in(names_data);
+      
+      for (int64_t i(0); i < MAX_RECS; i++) {
+	db::Rec<Foo> rec;
+	read(foo_cols, in, rec, nullopt);
+      }
+    });
+
+  run("cols read ords", [&ords_data]() {
+      InStream in(ords_data);
+      ColDict<Foo> dict;
+      Stream cols_buf;
+      write_cols(foo_cols, cols_buf);
+      read_cols(foo_cols, cols_buf, dict);
+      
+      for (int64_t i(0); i < MAX_RECS; i++) {
+	db::Rec<Foo> rec;
+	read_ords(dict, in, rec, nullopt);
+      }
+    });
+}
+
+const int64_t SEAL_RECS(10000);
+
+static void seal_perf() {
+  auto foos(init_foos());
+  foos.resize(SEAL_RECS);
+  std::vector<db::Rec<Foo>> recs;
+  for (auto &foo: foos) { recs.emplace_back(foo_cols, foo); }
+  crypt::Secret sec;
+  crypt::init_salt(sec);
+  crypt::init(sec, "db_perf");
+  Stream buf;
+  
+  run_allocs("seal write", SEAL_RECS, "rec", [&recs, &sec, &buf]() {
+      for (auto &rec: recs) { write_ords(rec, buf, sec); }
+    });
+
+  run_allocs("seal read", SEAL_RECS, "rec", [&buf, &sec]() {
+      ColDict<Foo> dict;
+      Stream cols_buf;
+      write_cols(foo_cols, cols_buf);
+      read_cols(foo_cols, cols_buf, dict);
+      db::Rec<Foo> rec;
+      
+      for (int64_t i(0); i < SEAL_RECS; i++) {
+	rec.clear();
+	read_ords(dict, buf, rec, sec);
+      }
+    });
+}
+
+static void find_perf() {
+  auto foos(init_foos());
+  const Path path("db_perf_find");
+  remove_path(path);
+  Proc proc(path, 100);
+  db::Ctx ctx(proc, 100);
+  Table<Foo, UId> tbl(ctx, "foos", foo_key, foo_cols);
+  std::map<std::tuple<UId>, db::Rec<Foo>> map_recs;
+  
+  for (auto &foo: foos) {
+    const db::Rec<Foo> rec(foo_cols, foo);
+    detach(tbl).emplace(tbl.key(rec), rec);
+    map_recs.emplace(tbl.key(rec), rec);
+  }
+
+  run("find map", [&foos, &tbl, &map_recs]() {
+      for (auto &foo: foos) {
+	CHECK(map_recs.find(tbl.key(foo.id)) != map_recs.end(), _);
+      }
+    });
+
+  run("find hash", [&foos, &tbl]() {
+      for (auto &foo: foos) {
+	CHECK(find(tbl, foo.id), _);
+      }
+    });
+
+  std::vector<UId> missing;
+  for (int64_t i(0); i < MAX_RECS; i++) { missing.emplace_back(true); }
+  
+  run("find missing map", [&missing, &tbl, &map_recs]() {
+      for (auto &id: missing) {
+	CHECK(map_recs.find(tbl.key(id)) == map_recs.end(), _);
+      }
+    });
+
+  run("find missing hash", [&missing, &tbl]() {
+      for (auto &id: missing) {
+	CHECK(!find(tbl, id), _);
+      }
+    });
+
+  remove_path(path);
+}
+
+const int64_t STARTUP_RECS(1000), STARTUP_UPDATES(1000000);
+
+static void startup_perf() {
+  const Path path("db_perf_startup");
+  remove_path(path);
+  auto foos(init_foos());
+  foos.resize(STARTUP_RECS);
+
+  {
+    Proc proc(path, 100);
+    db::Ctx ctx(proc, 100);
+    init_pass(ctx, "db_perf");
+    Table<Foo, UId> tbl(ctx, "foos", foo_key, foo_cols);
+    std::ofstream out(tbl.path.string(),
+		      std::ios::out | std::ios::binary | std::ios::trunc);
+    
+    for (int64_t i(0); i < STARTUP_UPDATES; i++) {
+      auto &foo(foos[i % STARTUP_RECS]);
+      foo.fint64++;
+      write(tbl, (i < STARTUP_RECS) ? TABLE_INSERT : TABLE_UPDATE,
+	    db::Rec<Foo>(foo_cols, foo), out);
+    }
+  }
+
+  Proc proc(path, 100);
+  db::Ctx ctx(proc, 100);
+  CHECK(login(ctx, "db_perf"), _);
+  Table<Foo, UId> tbl(ctx, "foos", foo_key, foo_cols);
+  report("startup log size", path_size(tbl.path), "bytes");
+  run("startup log", [&tbl]() { slurp(tbl); });
+  CHECK(tbl.recs->size(), _ == STARTUP_RECS);
+
+  const Path tmp_path(tbl.path.string() + ".tmp");
+
+  for (auto bs: {size_t(0), BLOCK_SIZE}) {
+    set_block_size(proc, bs);
+    
+    {
+      std::ifstream in(tbl.path.string(), std::ios::in | std::ios::binary);
+      std::ofstream out(tmp_path.string(),
+			std::ios::out | std::ios::binary | std::ios::trunc);
+      compact(tbl, in, out);
+    }
+
+    std::experimental::filesystem::rename(tmp_path, tbl.path);
+    const str id(bs ? "startup blocks" : "startup snapshot");
+    report(fmt("%0 size", id), path_size(tbl.path), "bytes");
+    detach(tbl).clear();
+    run(id, [&tbl]() { slurp(tbl); });
+    CHECK(tbl.recs->size(), _ == STARTUP_RECS);
+  }
+  
+  remove_path(path);
+}
+
+const int64_t TRANS_RECS(1000), TRANS_COUNT(10000), TRANS_CHANGES(12);
+
+static void trans_perf() {
+  const Path path("db_perf_trans");
+  remove_path(path);
+  auto foos(init_foos());
+  foos.resize(TRANS_RECS);
+  for (auto &foo: foos) { foo.fstr = str(1000, 'x'); }
+  Proc proc(path, 100);
+  set_sync(proc.write_loop, SYNC_NONE);
+  db::Ctx ctx(proc, 100);
+  init_pass(ctx, "db_perf");
+  Table<Foo, UId> tbl(ctx, "foos", foo_key, foo_cols);
+  
+  {
+    Trans trans(ctx);
+    for (auto &foo: foos) { insert(tbl, foo); }
+    commit(trans, nullopt);
+  }
+
+  run_allocs("trans rollback", TRANS_COUNT*TRANS_CHANGES, "change",
+	     [&foos, &ctx, &tbl]() {
+      for (int64_t i(0); i < TRANS_COUNT; i++) {
+	Trans trans(ctx);
+	
+	for (int64_t j(0); j < TRANS_CHANGES; j++) {
+	  auto &foo(foos[(i*TRANS_CHANGES + j) % TRANS_RECS]);
+	  foo.fint64++;
+	  update(tbl, foo);
+	}
+
+	rollback(trans);
+      }
+    });
+
+  run_allocs("trans commit", TRANS_COUNT*TRANS_CHANGES, "change",
+	     [&foos, &ctx, &tbl]() {
+      for (int64_t i(0); i < TRANS_COUNT; i++) {
+	Trans trans(ctx);
+	
+	for (int64_t j(0); j < TRANS_CHANGES; j++) {
+	  auto &foo(foos[(i*TRANS_CHANGES + j) % TRANS_RECS]);
+	  foo.fint64++;
+	  update(tbl, foo);
+	}
+
+	commit(trans, nullopt);
+      }
+    });
+
+  while (get_stats(proc.write_loop).commits < TRANS_COUNT+1) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  
+  auto stats(get_stats(proc.write_loop));
+  report("trans written", stats.written_bytes, "bytes");
+  report("trans compactions", stats.compactions, "count");
+  remove_path(path);
+}
+
+struct CtxSize {
+  int64_t peers, feeds, posts, tasks;
+};
+
+static CtxSize ctx_size {100, 10, 20000, 20000};
+
+const int64_t CTX_BATCH(1000), COMMIT_SAMPLES(1000);
+const size_t ID_LOOKUPS(100), PAGE_SIZE(100);
+
+const std::vector<str> CTX_WORDS {
+  "alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "golf", "hotel",
+    "india", "juliet", "kilo", "lima", "mike", "november", "oscar", "papa",
+    "quebec", "romeo", "sierra", "tango", "uniform", "victor", "whiskey",
+    "xray", "yankee", "zulu"
+    };
+
+static str ctx_words(std::mt19937_64 &rnd, size_t cnt) {
+  str out;
+  
+  for (size_t i(0); i < cnt; i++) {
+    if (i) { out += ' '; }
+    out += CTX_WORDS[rnd() % CTX_WORDS.size()];
+  }
+
+  return out;
+}
+
+template <typename FnT>
+static void run_batched(snackis::Ctx &ctx, const str &id, int64_t cnt, const FnT &fn) {
+  run(id, [&ctx, cnt, &fn]() {
+      for (int64_t i(0); i < cnt; i += CTX_BATCH) {
+	db::Trans trans(ctx);
+	for (int64_t j(i); j < std::min(i+CTX_BATCH, cnt); j++) { fn(j); }
+	commit(trans, nullopt);
+      }
+    });
+}
+
+static int64_t ctx_bytes(snackis::Ctx &ctx) {
+  int64_t out(0);
+  for (auto &t: ctx.tables) { out += path_size(t.second->path); }
+  return out;
+}
+
+static void ctx_perf() {
+  const Path path("db_perf_ctx");
+  remove_path(path);
+  std::mt19937_64 rnd(42);
+  std::vector<UId> feed_ids, post_ids, task_ids;
+  
+  {
+    Proc proc(path, 100);
+    snackis::Ctx ctx(proc, 100);
+    init_pass(ctx, "db_perf");
+    open(ctx);
+    Project prj(ctx);
+    prj.name = "db_perf";
+
+    {
+      db::Trans trans(ctx);
+      insert(ctx.db.projects, prj);
+      commit(trans, nullopt);
+    }
+
+    run_batched(ctx, "ctx insert peers", ctx_size.peers, [&ctx, &rnd](int64_t i) {
+	Peer pr(ctx);
+	pr.name = fmt("peer %0", i);
+	pr.email = fmt("peer%0@db.perf", i);
+	pr.info = ctx_words(rnd, 10);
+	insert(ctx.db.peers, pr);
+      });
+    
+    run_batched(ctx, "ctx insert feeds", ctx_size.feeds,
+		[&ctx, &rnd, &feed_ids](int64_t i) {
+		  Feed fd(ctx);
+		  fd.name = fmt("feed %0", i);
+		  fd.info = ctx_words(rnd, 10);
+		  fd.tags.insert(CTX_WORDS[i % CTX_WORDS.size()]);
+		  insert(ctx.db.feeds, fd);
+		  feed_ids.push_back(fd.id);
+		});
+
+    run_batched(ctx, "ctx insert posts", ctx_size.posts,
+		[&ctx, &rnd, &feed_ids, &post_ids](int64_t i) {
+		  Post ps(ctx);
+		  if (!feed_ids.empty()) { ps.feed_id = feed_ids[i % feed_ids.size()]; }
+		  ps.body = ctx_words(rnd, 20);
+		  ps.tags.insert(CTX_WORDS[rnd() % CTX_WORDS.size()]);
+		  insert(ctx.db.posts, ps);
+		  post_ids.push_back(ps.id);
+		});
+
+    run_batched(ctx, "ctx insert tasks", ctx_size.tasks,
+		[&ctx, &rnd, &prj, &task_ids](int64_t i) {
+		  Task tsk(ctx);
+		  tsk.project_id = prj.id;
+		  tsk.name = ctx_words(rnd, 3);
+		  tsk.info = ctx_words(rnd, 20);
+		  tsk.tags.insert(CTX_WORDS[rnd() % CTX_WORDS.size()]);
+		  tsk.prio = i % 10;
+		  insert(ctx.db.tasks, tsk);
+		  task_ids.push_back(tsk.id);
+		});
+
+    run_batched(ctx, "ctx update tasks", task_ids.size(),
+		[&ctx, &task_ids](int64_t i) {
+		  Task tsk(get_task_id(ctx, task_ids[i]));
+		  tsk.prio++;
+		  update(ctx.db.tasks, tsk);
+		});
+
+    run_batched(ctx, "ctx erase posts", post_ids.size() / 10,
+		[&ctx, &post_ids](int64_t i) {
+		  erase(ctx.db.posts, post_ids[i*10]);
+		});
+
+    if (!task_ids.empty()) {
+      std::vector<int64_t> lats;
+      
+      for (int64_t i(0); i < COMMIT_SAMPLES; i++) {
+	db::Trans trans(ctx);
+	Task tsk(get_task_id(ctx, task_ids[i % task_ids.size()]));
+	tsk.info = fmt("commit %0", i);
+	update(ctx.db.tasks, tsk);
+	auto start(pnow());
+	CHECK(commit_durable(trans, nullopt).get(), _);
+	lats.push_back(usecs(pnow()-start));
+      }
+
+      std::sort(lats.begin(), lats.end());
+      report("ctx commit p50", lats[lats.size() / 2], "us");
+      report("ctx commit p99", lats[lats.size() * 99 / 100], "us");
+      report("ctx commit max", lats.back(), "us");
+    }
+
+    int64_t found(0);
+    
+    run("ctx search post body", [&ctx, &found]() {
+	auto cur(scan(ctx.db.posts_sort));
+	reverse(cur);
+	
+	while (auto key = fetch(cur)) {
+	  Post ps(ctx, *key->second);
+	  if (find_ci(ps.body, "tango foxtrot") != str::npos) { found++; }
+	}
+      });
+
+    report("ctx search post body hits", found, "count");
+    found = 0;
+
+    run("ctx search post text", [&ctx, &found]() {
+	Query<Post, UId> qry(ctx.db.posts);
+	match(qry, ctx.db.posts_text, "tango foxtrot");
+	auto cur(scan(ctx.db.posts_sort));
+	
+	found = run(qry, ctx.db.posts_sort, reverse(cur), [&ctx](auto &rec) {
+	    Post ps(ctx, rec);
+	  });
+      });
+
+    report("ctx search post text hits", found, "count");
+    found = 0;
+    
+    run("ctx search task tag", [&ctx, &found]() {
+	auto cur(scan(ctx.db.tasks_sort));
+	
+	while (auto key = fetch(cur)) {
+	  Task tsk(ctx, *key->second);
+	  if (tsk.tags.find("tango") != tsk.tags.end()) { found++; }
+	}
+      });
+
+    report("ctx search task tag hits", found, "count");
+    found = 0;
+
+    run("ctx search task tag index", [&ctx, &found]() {
+	Query<Task, UId> qry(ctx.db.tasks);
+	tagged(qry, ctx.db.tasks_tags, {"tango"});
+
+	found = run(qry, ctx.db.tasks_sort, [&ctx](auto &rec) {
+	    Task tsk(ctx, rec);
+	  });
+      });
+
+    report("ctx search task tag index hits", found, "count");
+    found = 0;
+
+    run("ctx query task", [&ctx, &found]() {
+	const UId me(whoamid(ctx));
+	Query<Task, UId> qry(ctx.db.tasks);
+	eq(qry, task_done, false);
+	range(qry, task_prio, opt<int64_t>(1), opt<int64_t>());
+	contains(qry, task_info, "tango");
+	
+	filter(qry, [&me](auto &rec) {
+	    return field(rec, task_owner_id) == me || field(rec, task_peer_ids).count(me);
+	  });
+	
+	limit(qry, 100);
+
+	found = run(qry, ctx.db.tasks_sort, [&ctx](auto &rec) {
+	    Task tsk(ctx, rec);
+	  });
+      });
+
+    report("ctx query task hits", found, "count");
+
+    run("ctx query post page", [&ctx, &found]() {
+	Query<Post, UId> qry(ctx.db.posts);
+	limit(qry, PAGE_SIZE);
+	opt<KeyIndex<Post, Time, UId>::Key::Type> last;
+	
+	for (int i(0); i < 2; i++) {
+	  auto cur(scan(ctx.db.posts_sort));
+	  
+	  found = run(qry, ctx.db.posts_sort, reverse(cur), last, [&ctx](auto &rec) {
+	      Post ps(ctx, rec);
+	    });
+	}
+      });
+
+    report("ctx query post page hits", found, "count");
+
+    run("ctx query task tag page", [&ctx, &found]() {
+	Query<Task, UId> qry(ctx.db.tasks);
+	tagged(qry, ctx.db.tasks_tags, {"tango"});
+	limit(qry, PAGE_SIZE);
+	auto cur(scan(ctx.db.tasks_sort));
+
+	found = run(qry, ctx.db.tasks_sort, reverse(cur), [&ctx](auto &rec) {
+	    Task tsk(ctx, rec);
+	  });
+      });
+
+    report("ctx query task tag page hits", found, "count");
+
+    std::vector<str> ids;
+    auto id_cur(scan(ctx.db.posts));
+    while (auto it = fetch(id_cur)) {
+      if (ids.size() == ID_LOOKUPS) { break; }
+      ids.push_back(to_str(std::get<0>(it->first)).substr(0, 8));
+    }
+    found = 0;
+
+    run("ctx find id str", [&ctx, &ids, &found]() {
+	for (auto &id: ids) {
+	  auto cur(scan(ctx.db.posts));
+	  
+	  while (auto it = fetch(cur)) {
+	    if (find_ci(to_str(std::get<0>(it->first)).substr(0, 8), id) != str::npos) {
+	      found++;
+	    }
+	  }
+	}
+      });
+
+    report("ctx find id str hits", found, "count");
+    found = 0;
+
+    run("ctx find id prefix", [&ctx, &ids, &found]() {
+	for (auto &id: ids) {
+	  auto cur(scan_id(ctx.db.posts, id));
+	  while (fetch(cur)) { found++; }
+	}
+      });
+
+    report("ctx find id prefix hits", found, "count");
+    report("ctx log size", ctx_bytes(ctx), "bytes");
+    run("ctx rewrite", [&ctx]() { rewrite_db(ctx); });
+  }
+
+  Proc proc(path, 100);
+  snackis::Ctx ctx(proc, 100);
+  CHECK(login(ctx, "db_perf"), _);
+  run("ctx slurp", [&ctx]() { open(ctx); });
+  CHECK(int64_t(ctx.db.tasks.recs->size()), _ == ctx_size.tasks);
+  report("ctx snapshot size", ctx_bytes(ctx), "bytes");
+  remove_path(path);
+}
+
+static void parse_args(int argc, char **argv) {
+  for (int i(1); i < argc; i++) {
+    const str arg(argv[i]);
+    
+    if (arg == "--csv") {
+      format = FORMAT_CSV;
+    } else if (arg == "--json") {
+      format = FORMAT_JSON;
+    } else if (i+1 < argc &&
+	       (arg == "--peers" || arg == "--feeds" ||
+		arg == "--posts" || arg == "--tasks")) {
+      const int64_t val(to_int64(argv[++i]));
+      if (arg == "--peers") { ctx_size.peers = val; }
+      else if (arg == "--feeds") { ctx_size.feeds = val; }
+      else if (arg == "--posts") { ctx_size.posts = val; }
+      else { ctx_size.tasks = val; }
+    } else {
+      std::cerr << "Usage: db_perf [--csv|--json] [--peers N] [--feeds N] "
+	"[--posts N] [--tasks N]" << std::endl;
+      exit(1);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  TRY(try_perf);
+  init();
+  parse_args(argc, argv);
+  rec_perf();
+  enc_perf(INT64_STR, "str");
+  enc_perf(INT64_VARINT, "varint");
+  cols_perf();
+  seal_perf();
+  find_perf();
+  startup_perf();
+  trans_perf();
+  ctx_perf();
+  print_results();
+  return 0;
+}
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "snackis/core/buf.hpp"
+
+namespace snackis {
+  const size_t BUF_POOL_MAX(16);
+
+  static thread_local std::vector<std::unique_ptr<Buf>> buf_pool;
+
+  Buf::Buf(): head(0) { clear(*this); }
+
+  unsigned char *Buf::begin() {
+    return reinterpret_cast<unsigned char *>(pbase());
+  }
+
+  size_t Buf::size() const { return pptr() - pbase(); }
+
+  unsigned char *Buf::reserve(size_t len) {
+    const size_t used(head + size());
+
+    if (data.size() < used + len) {
+      data.resize(std::max(data.size() * 2, used + len));
+      char *beg(reinterpret_cast<char *>(&data[0]));
+      setp(beg + head, beg + data.size());
+      pbump(used - head);
+    }
+
+    return reinterpret_cast<unsigned char *>(pptr());
+  }
+
+  void Buf::commit(size_t len) { pbump(len); }
+
+  Buf::int_type Buf::overflow(int_type c) {
+    if (traits_type::eq_int_type(c, traits_type::eof())) {
+      return traits_type::not_eof(c);
+    }
+
+    *reserve(1) = traits_type::to_char_type(c);
+    pbump(1);
+    return c;
+  }
+
+  std::streamsize Buf::xsputn(const char *in, std::streamsize len) {
+    memcpy(reserve(len), in, len);
+    pbump(len);
+    return len;
+  }
+
+  SpanBuf::SpanBuf(const unsigned char *beg, size_t len) {
+    char *p(const_cast<char *>(reinterpret_cast<const char *>(beg)));
+    setg(p, p, p + len);
+  }
+
+  SpanBuf::pos_type SpanBuf::seekoff(off_type offs,
+				     std::ios_base::seekdir dir,
+				     std::ios_base::openmode which) {
+    if (!(which & std::ios_base::in)) { return pos_type(off_type(-1)); }
+    char *base(dir == std::ios_base::beg
+	       ? eback()
+	       : (dir == std::ios_base::cur ? gptr() : egptr()));
+    char *p(base + offs);
+    if (p < eback() || p > egptr()) { return pos_type(off_type(-1)); }
+    setg(eback(), p, egptr());
+    return pos_type(p - eback());
+  }
+
+  SpanBuf::pos_type SpanBuf::seekpos(pos_type pos, std::ios_base::openmode which) {
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+  }
+
+  static Buf &take_buf() {
+    if (buf_pool.empty()) { return *new Buf(); }
+    Buf *buf(buf_pool.back().release());
+    buf_pool.pop_back();
+    return *buf;
+  }
+  
+  TmpBuf::TmpBuf(size_t head): buf(take_buf()) { clear(buf, head); }
+
+  TmpBuf::~TmpBuf() {
+    if (buf_pool.size() < BUF_POOL_MAX) {
+      buf_pool.emplace_back(&buf);
+    } else {
+      delete &buf;
+    }
+  }
+
+  void clear(Buf &buf, size_t head) {
+    if (buf.data.size() < head) { buf.data.resize(head); }
+    buf.head = head;
+    char *beg(reinterpret_cast<char *>(buf.data.data()));
+    buf.setp(beg + head, beg + buf.data.size());
+  }
+}
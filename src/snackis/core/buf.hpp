@@ -0,0 +1,41 @@
+#ifndef SNACKIS_BUF_HPP
+#define SNACKIS_BUF_HPP
+
+#include <streambuf>
+#include "snackis/core/data.hpp"
+
+namespace snackis {
+  struct Buf: std::streambuf {
+    Data data;
+    size_t head;
+
+    Buf();
+    unsigned char *begin();
+    size_t size() const;
+    unsigned char *reserve(size_t len);
+    void commit(size_t len);
+    friend void clear(Buf &buf, size_t head);
+  protected:
+    int_type overflow(int_type c) override;
+    std::streamsize xsputn(const char *in, std::streamsize len) override;
+  };
+
+  struct SpanBuf: std::streambuf {
+    SpanBuf(const unsigned char *beg, size_t len);
+  protected:
+    pos_type seekoff(off_type offs,
+		     std::ios_base::seekdir dir,
+		     std::ios_base::openmode which) override;
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+  };
+
+  struct TmpBuf {
+    Buf &buf;
+    TmpBuf(size_t head=0);
+    ~TmpBuf();
+  };
+
+  void clear(Buf &buf, size_t head=0);
+}
+
+#endif
@@ -1,4 +1,5 @@
 #include <fstream>
+#include <zlib.h>
 #include "snackis/core/defer.hpp"
 #include "snackis/core/data.hpp"
 
@@ -22,4 +23,27 @@ namespace snackis {
     f.read(reinterpret_cast<char *>(&buf[0]), buf.size());
     return buf;
   }
+
+  Data compress(const unsigned char *in, size_t len) {
+    uLongf out_len(compressBound(len));
+    Data out(out_len, 0);
+    compress2(&out[0], &out_len, in, len, Z_BEST_SPEED);
+    out.resize(out_len);
+    return out;
+  }
+
+  size_t compress_bound(size_t len) { return compressBound(len); }
+
+  size_t compress(const unsigned char *in, size_t len,
+		  unsigned char *out, size_t out_len) {
+    uLongf res_len(out_len);
+    if (compress2(out, &res_len, in, len, Z_BEST_SPEED) != Z_OK) { return 0; }
+    return res_len;
+  }
+
+  bool uncompress(const unsigned char *in, size_t len,
+		  unsigned char *out, size_t out_len) {
+    uLongf res_len(out_len);
+    return ::uncompress(out, &res_len, in, len) == Z_OK && res_len == out_len;
+  }
 }
@@ -9,6 +9,12 @@ namespace snackis {
 
   void dump_data(const Data &buf, const Path &p);
   Data slurp_data(const Path &in);
+  Data compress(const unsigned char *in, size_t len);
+  size_t compress_bound(size_t len);
+  size_t compress(const unsigned char *in, size_t len,
+		  unsigned char *out, size_t out_len);
+  bool uncompress(const unsigned char *in, size_t len,
+		  unsigned char *out, size_t out_len);
 }
 
 #endif
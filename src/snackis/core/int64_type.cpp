@@ -4,6 +4,11 @@
 namespace snackis {
   Int64Type int64_type;
 
+  static int int64_enc_idx() {
+    static const int idx(std::ios_base::xalloc());
+    return idx;
+  }
+  
   Int64Type::Int64Type(): Type<int64_t>("Int64")
   { }
 
@@ -11,7 +16,7 @@ namespace snackis {
 
   Val Int64Type::to_val(const int64_t &in) const { return in; }
 
-  int64_t Int64Type::read(std::istream &in) const {
+  static int64_t read_str(std::istream &in) {
     uint8_t len;
     in.read((char *)&len, sizeof len);
     std::vector<char> data(len);
@@ -19,11 +24,55 @@ namespace snackis {
     const str str_val(data.begin(), data.end());
     return to_int64(str_val);    
   }
+
+  static int64_t read_varint(std::istream &in) {
+    uint64_t val(0);
+    
+    for (int shift(0); shift < 64; shift += 7) {
+      auto b(in.get());
+      if (b == std::istream::traits_type::eof()) { break; }
+      val |= uint64_t(b & 0x7f) << shift;
+      if (!(b & 0x80)) { break; }
+    }
+
+    return int64_t(val >> 1) ^ -int64_t(val & 1);
+  }
   
-  void Int64Type::write(const int64_t &val, std::ostream &out) const {
+  int64_t Int64Type::read(std::istream &in) const {
+    return (get_int64_enc(in) == INT64_STR) ? read_str(in) : read_varint(in);
+  }
+  
+  static void write_str(int64_t val, std::ostream &out) {
     const str str_val(to_str(val));
     uint8_t len(str_val.size());
     out.write((char *)&len, sizeof len);
     out.write(str_val.data(), len);
   }
+
+  static void write_varint(int64_t val, std::ostream &out) {
+    uint64_t zz((uint64_t(val) << 1) ^ uint64_t(val >> 63));
+
+    while (zz >= 0x80) {
+      out.put(char(zz | 0x80));
+      zz >>= 7;
+    }
+
+    out.put(char(zz));
+  }
+
+  void Int64Type::write(const int64_t &val, std::ostream &out) const {
+    if (get_int64_enc(out) == INT64_STR) {
+      write_str(val, out);
+    } else {
+      write_varint(val, out);
+    }
+  }
+
+  Int64Enc get_int64_enc(std::ios_base &s) {
+    return Int64Enc(s.iword(int64_enc_idx()));
+  }
+  
+  void set_int64_enc(std::ios_base &s, Int64Enc enc) {
+    s.iword(int64_enc_idx()) = enc;
+  }
 }
@@ -5,6 +5,8 @@
 #include "snackis/core/type.hpp"
 
 namespace snackis {
+  enum Int64Enc {INT64_VARINT=0, INT64_STR};
+  
   struct Int64Type: Type<int64_t> {
     Int64Type();
     int64_t from_val(const Val &in) const override;
@@ -14,6 +16,9 @@ namespace snackis {
   };
 
   extern Int64Type int64_type;
+
+  Int64Enc get_int64_enc(std::ios_base &s);
+  void set_int64_enc(std::ios_base &s, Int64Enc enc);
 }
 
 #endif
@@ -0,0 +1,86 @@
+#include "snackis/core/parallel.hpp"
+
+namespace snackis {
+  static void work(Pool *pool) {
+    while (true) {
+      Pool::Job job;
+      
+      {
+	std::unique_lock<std::mutex> lock(pool->mutex);
+	pool->ready.wait(lock, [pool]() {
+	    return pool->stopping || !pool->jobs.empty();
+	  });
+	if (pool->jobs.empty()) { return; }
+	job = std::move(pool->jobs.front());
+	pool->jobs.pop_front();
+      }
+
+      job();
+    }
+  }
+  
+  Pool::Pool(size_t size):
+    stopping(false)
+  {
+    for (size_t i(0); i < size; i++) { threads.emplace_back(work, this); }
+  }
+
+  Pool::~Pool() {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      stopping = true;
+    }
+
+    ready.notify_all();
+    for (auto &t: threads) { t.join(); }
+  }
+
+  ParallelFor::ParallelFor(size_t cnt, const func<void (size_t)> &fn):
+    cnt(cnt), fn(fn), next(0), running(0), threads(1), done(false)
+  { }
+  
+  size_t max_threads() {
+    return std::max(std::thread::hardware_concurrency(), 1U);
+  }
+
+  Pool &thread_pool() {
+    static Pool pool(max_threads()-1);
+    return pool;
+  }
+
+  void post(Pool &pool, const Pool::Job &job) {
+    {
+      std::unique_lock<std::mutex> lock(pool.mutex);
+      pool.jobs.push_back(job);
+    }
+
+    pool.ready.notify_one();
+  }
+
+  void run_for(ParallelFor &pf) {
+    TRY(try_parallel);
+    for (size_t i; (i = pf.next++) < pf.cnt;) { pf.fn(i); }
+    std::deque<Error *> errors;
+    std::swap(errors, try_parallel.errors);
+    std::unique_lock<std::mutex> lock(pf.mutex);
+    std::copy(errors.begin(), errors.end(), std::back_inserter(pf.errors));
+  }
+  
+  void help_for(const std::shared_ptr<ParallelFor> &pf) {
+    {
+      std::unique_lock<std::mutex> lock(pf->mutex);
+      if (pf->done || pf->next.load() >= pf->cnt) { return; }
+      pf->running++;
+      pf->threads++;
+    }
+
+    run_for(*pf);
+
+    {
+      std::unique_lock<std::mutex> lock(pf->mutex);
+      pf->running--;
+    }
+    
+    pf->idle.notify_all();
+  }
+}
@@ -0,0 +1,65 @@
+#ifndef SNACKIS_PARALLEL_HPP
+#define SNACKIS_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "snackis/core/error.hpp"
+#include "snackis/core/func.hpp"
+
+namespace snackis {
+  struct Pool {
+    using Job = func<void ()>;
+
+    std::vector<std::thread> threads;
+    std::deque<Job> jobs;
+    std::mutex mutex;
+    std::condition_variable ready;
+    bool stopping;
+    
+    Pool(size_t size);
+    ~Pool();
+  };
+
+  struct ParallelFor {
+    const size_t cnt;
+    const func<void (size_t)> fn;
+    std::atomic<size_t> next;
+    std::mutex mutex;
+    std::condition_variable idle;
+    size_t running, threads;
+    bool done;
+    std::deque<Error *> errors;
+
+    ParallelFor(size_t cnt, const func<void (size_t)> &fn);
+  };
+  
+  size_t max_threads();
+  Pool &thread_pool();
+  void post(Pool &pool, const Pool::Job &job);
+  void run_for(ParallelFor &pf);
+  void help_for(const std::shared_ptr<ParallelFor> &pf);
+  
+  template <typename FnT>
+  size_t parallel_for(size_t cnt, size_t max_threads, const FnT &fn) {
+    const size_t thread_cnt(std::max(std::min(max_threads, cnt), size_t(1)));
+    auto pf(std::make_shared<ParallelFor>(cnt, [&fn](size_t i) { fn(i); }));
+    auto &pool(thread_pool());
+    for (size_t j(1); j < thread_cnt; j++) { post(pool, [pf]() { help_for(pf); }); }
+    run_for(*pf);
+    
+    std::unique_lock<std::mutex> lock(pf->mutex);
+    pf->done = true;
+    pf->idle.wait(lock, [&pf]() { return !pf->running; });
+    for (auto e: pf->errors) { throw_error(e); }
+    return pf->threads;
+  }
+}
+
+#endif
@@ -1,3 +1,5 @@
+#include <fcntl.h>
+#include <unistd.h>
 #include "snackis/core/path.hpp"
 
 namespace snackis {  
@@ -14,4 +16,27 @@ namespace snackis {
     std::experimental::filesystem::remove_all(p, e);
     return e.value() == 0;
   }
+
+  uintmax_t path_size(const Path &p) {
+    std::error_code e;
+    auto res(std::experimental::filesystem::file_size(p, e));
+    return e ? 0 : res;
+  }
+
+  bool sync_path(const Path &p) {
+    int fd(::open(p.string().c_str(), O_RDONLY));
+    if (fd == -1) { return false; }
+    bool ok(fdatasync(fd) == 0);
+    ::close(fd);
+    return ok;
+  }
+
+  bool sync_dir(const Path &p) {
+    const Path dir(p.parent_path());
+    int fd(::open(dir.empty() ? "." : dir.string().c_str(), O_RDONLY | O_DIRECTORY));
+    if (fd == -1) { return false; }
+    bool ok(fsync(fd) == 0);
+    ::close(fd);
+    return ok;
+  }
 }
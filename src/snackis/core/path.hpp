@@ -10,6 +10,9 @@ namespace snackis {
   bool create_path(const Path &p);
   bool path_exists(const Path &p);
   bool remove_path(const Path &p);
+  uintmax_t path_size(const Path &p);
+  bool sync_path(const Path &p);
+  bool sync_dir(const Path &p);
 }
 
 #endif
@@ -37,20 +37,36 @@ namespace snackis {
     while (in_words >> w) { out.insert(w); }
     return out;
   }
+
+  std::set<str> text_words(const str &in) {
+    std::set<str> out;
+    str w;
+    
+    for (unsigned char c: in) {
+      if (c >= 0x80 || std::isalnum(c)) {
+	w.push_back(std::tolower(c));
+      } else if (!w.empty()) {
+	out.insert(w);
+	w.clear();
+      }
+    }
+
+    if (!w.empty()) { out.insert(w); }
+    return out;
+  }
   
   int64_t to_int64(const str &in) {
     return strtoll(in.c_str(), nullptr, 10);
   }
 
   str bin_hex(const unsigned char *in, size_t len) {
-    const size_t out_len = len*2+1;
-    Data out(out_len, 0);
+    str out(len*2, 0);
     
-    if (!sodium_bin2hex(reinterpret_cast<char *>(&out[0]), out_len, in, len)) {
+    if (!sodium_bin2hex(&out[0], out.size()+1, in, len)) {
       ERROR(Core, "Hex-encoding failed");
     }
 
-    return str(reinterpret_cast<const char *>(&out[0]));
+    return out;
   }
   
   Data hex_bin(const str &in) {
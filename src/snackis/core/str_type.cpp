@@ -16,9 +16,9 @@ namespace snackis {
   str StrType::read(std::istream &in) const {
     int64_t len(int64_type.read(in));
     if (!len) { return ""; }
-    std::vector<char> data(len);
+    str data(len, 0);
     in.read(&data[0], len);
-    return str(data.begin(), data.end());
+    return data;
   }
   
   void StrType::write(const str &val, std::ostream &out) const {
@@ -1,3 +1,5 @@
+#include <cctype>
+#include <cstring>
 #include <vector>
 #include "snackis/core/uid.hpp"
 
@@ -37,4 +39,29 @@ namespace snackis {
     if (uuid_parse(in.c_str(), out.val) != 0) { return nullopt; }
     return out;
   }
+
+  opt<std::pair<UId, UId>> parse_uid_prefix(const str &in) {
+    UId min, max;
+    memset(max.val, 0xff, sizeof max.val);
+    size_t i(0);
+
+    for (unsigned char c: in) {
+      if (c == '-') { continue; }
+      if (!isxdigit(c) || i == sizeof min.val * 2) { return nullopt; }
+      const unsigned char n(isdigit(c) ? c - '0' : tolower(c) - 'a' + 10);
+      const size_t j(i / 2);
+      
+      if (i % 2) {
+	min.val[j] = (min.val[j] & 0xf0) | n;
+	max.val[j] = (max.val[j] & 0xf0) | n;
+      } else {
+	min.val[j] = n << 4;
+	max.val[j] = (n << 4) | 0x0f;
+      }
+      
+      i++;
+    }
+
+    return std::make_pair(min, max);
+  }
 }
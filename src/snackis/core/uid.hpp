@@ -1,6 +1,7 @@
 #ifndef SNACKIS_UID_HPP
 #define SNACKIS_UID_HPP
 
+#include <utility>
 #include <uuid/uuid.h>
 #include "snackis/core/fmt.hpp"
 #include "snackis/core/str.hpp"
@@ -22,6 +23,7 @@ namespace snackis {
   template <>
   str fmt_arg(const UId &arg);
   opt<UId> parse_uid(const str &in);
+  opt<std::pair<UId, UId>> parse_uid_prefix(const str &in);
 }
 
 #endif
@@ -0,0 +1,128 @@
+#ifndef SNACKIS_UID_MAP_HPP
+#define SNACKIS_UID_MAP_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "snackis/core/uid.hpp"
+
+namespace snackis {
+  enum UIdSlotState {UID_SLOT_EMPTY, UID_SLOT_USED, UID_SLOT_DEAD};
+
+  const size_t UID_MAP_MIN_SLOTS(16);
+
+  template <typename ValT>
+  struct UIdSlot {
+    UId key;
+    ValT val;
+    UIdSlotState state;
+    UIdSlot();
+  };
+
+  template <typename ValT>
+  struct UIdMap {
+    std::vector<UIdSlot<ValT>> slots;
+    size_t used, dead;
+    UIdMap();
+  };
+
+  template <typename ValT>
+  UIdSlot<ValT>::UIdSlot():
+    state(UID_SLOT_EMPTY)
+  { }
+
+  template <typename ValT>
+  UIdMap<ValT>::UIdMap():
+    used(0), dead(0)
+  { }
+
+  inline size_t hash(const UId &id) {
+    uint64_t x, y;
+    memcpy(&x, id.val, sizeof x);
+    memcpy(&y, id.val + sizeof x, sizeof y);
+    return (x ^ y) * 0x9e3779b97f4a7c15ULL;
+  }
+
+  inline bool same_uid(const UId &x, const UId &y) {
+    return memcmp(x.val, y.val, sizeof x.val) == 0;
+  }
+
+  template <typename ValT>
+  UIdSlot<ValT> *find_slot(UIdMap<ValT> &m, const UId &key) {
+    if (m.slots.empty()) { return nullptr; }
+    const size_t mask(m.slots.size()-1);
+
+    for (size_t i(hash(key) & mask);; i = (i+1) & mask) {
+      auto &s(m.slots[i]);
+      if (s.state == UID_SLOT_EMPTY) { return nullptr; }
+      if (s.state == UID_SLOT_USED && same_uid(s.key, key)) { return &s; }
+    }
+  }
+
+  template <typename ValT>
+  ValT *find(UIdMap<ValT> &m, const UId &key) {
+    auto s(find_slot(m, key));
+    return s ? &s->val : nullptr;
+  }
+
+  template <typename ValT>
+  void resize(UIdMap<ValT> &m, size_t cnt) {
+    std::vector<UIdSlot<ValT>> prev(cnt);
+    std::swap(prev, m.slots);
+    const size_t mask(cnt-1);
+    m.dead = 0;
+
+    for (auto &s: prev) {
+      if (s.state != UID_SLOT_USED) { continue; }
+      size_t i(hash(s.key) & mask);
+      while (m.slots[i].state != UID_SLOT_EMPTY) { i = (i+1) & mask; }
+      m.slots[i] = s;
+    }
+  }
+
+  template <typename ValT>
+  void insert(UIdMap<ValT> &m, const UId &key, const ValT &val) {
+    if ((m.used + m.dead + 1) * 2 > m.slots.size()) {
+      size_t cnt(std::max(m.slots.size(), UID_MAP_MIN_SLOTS));
+      while ((m.used+1) * 2 > cnt) { cnt *= 2; }
+      resize(m, cnt);
+    }
+
+    auto s(find_slot(m, key));
+
+    if (s) {
+      s->val = val;
+      return;
+    }
+
+    const size_t mask(m.slots.size()-1);
+    size_t i(hash(key) & mask);
+    while (m.slots[i].state == UID_SLOT_USED) { i = (i+1) & mask; }
+    auto &ns(m.slots[i]);
+    if (ns.state == UID_SLOT_DEAD) { m.dead--; }
+    ns.key = key;
+    ns.val = val;
+    ns.state = UID_SLOT_USED;
+    m.used++;
+  }
+
+  template <typename ValT>
+  bool erase(UIdMap<ValT> &m, const UId &key) {
+    auto s(find_slot(m, key));
+    if (!s) { return false; }
+    s->state = UID_SLOT_DEAD;
+    m.used--;
+    m.dead++;
+    return true;
+  }
+
+  template <typename ValT>
+  void clear(UIdMap<ValT> &m) {
+    m.slots.clear();
+    m.used = m.dead = 0;
+  }
+}
+
+#endif
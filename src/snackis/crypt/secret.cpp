@@ -59,4 +59,39 @@ namespace crypt {
     out.resize(dlen);
     return out;
   }
+
+  size_t encrypt_buf(const Secret &sec, Buf &buf) {
+    const size_t len(buf.size());
+    buf.reserve(Secret::TAG_SIZE);
+    unsigned char *out(&buf.data[0] + buf.head - Secret::NONCE_SIZE);
+    randombytes_buf(out, Secret::NONCE_SIZE);
+
+    unsigned long long clen;
+    crypto_aead_chacha20poly1305_ietf_encrypt(out+Secret::NONCE_SIZE, &clen,
+					      out+Secret::NONCE_SIZE, len,
+					      nullptr, 0,
+					      nullptr, out, hash(sec));
+    return Secret::NONCE_SIZE+clen;
+  }
+
+  size_t decrypt_buf(const Secret &sec, unsigned char *buf, size_t len) {
+    if (len < Secret::NONCE_SIZE+Secret::TAG_SIZE) {
+      ERROR(Crypt, "Failed decrypting secret message");
+      return 0;
+    }
+    
+    unsigned long long dlen;
+    if (crypto_aead_chacha20poly1305_ietf_decrypt(buf+Secret::NONCE_SIZE,
+						  &dlen,
+						  nullptr,
+						  buf+Secret::NONCE_SIZE,
+						  len-Secret::NONCE_SIZE,
+						  nullptr, 0,
+						  buf, hash(sec)) != 0) {
+      ERROR(Crypt, "Failed decrypting secret message");
+      return 0;
+    }
+
+    return dlen;
+  }
 }}
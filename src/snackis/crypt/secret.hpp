@@ -3,6 +3,7 @@
 
 #include <sodium.h>
 
+#include "snackis/core/buf.hpp"
 #include "snackis/core/data.hpp"
 #include "snackis/core/str.hpp"
 
@@ -13,7 +14,8 @@ namespace crypt {
     SALT_SIZE = crypto_pwhash_scryptsalsa208sha256_SALTBYTES,
       KEY_SIZE = crypto_aead_chacha20poly1305_IETF_KEYBYTES,
       SIZE = SALT_SIZE + KEY_SIZE,
-      NONCE_SIZE = crypto_aead_chacha20poly1305_IETF_NPUBBYTES;
+      NONCE_SIZE = crypto_aead_chacha20poly1305_IETF_NPUBBYTES,
+      TAG_SIZE = crypto_aead_chacha20poly1305_IETF_ABYTES;
 
     unsigned char data[SIZE];
 
@@ -26,6 +28,8 @@ namespace crypt {
 
   Data encrypt(const Secret &secret, const unsigned char *in, size_t len);
   Data decrypt(const Secret &secret, const unsigned char *in, size_t len);
+  size_t encrypt_buf(const Secret &secret, Buf &buf);
+  size_t decrypt_buf(const Secret &secret, unsigned char *buf, size_t len);
 }}
   
 #endif
@@ -1,5 +1,6 @@
 #include <chrono>
 #include "snackis/ctx.hpp"
+#include "snackis/snackis.hpp"
 #include "snackis/db/error.hpp"
 #include "snackis/net/imap.hpp"
 #include "snackis/net/smtp.hpp"
@@ -9,7 +10,21 @@ namespace snackis {
     db::Ctx(p, max_buf), db(*this), settings(*this)
   { }
 
-  void open(Ctx &ctx) {
+  Ctx::~Ctx() { db::disconnect(*this); }
+
+  static void remove_stale_indexes(Ctx &ctx) {
+    for (auto n: {"peers_sort", "scripts_sort", "feeds_sort", "posts_sort",
+	  "feed_posts", "inbox_sort", "projects_sort", "tasks_sort"}) {
+      auto p(get_path(ctx, fmt("%0.tbl", n)));
+      
+      if (path_exists(p)) {
+	remove_path(p);
+	log(ctx, fmt("Removed stale index: %0", n));
+      }
+    }
+  }
+  
+  bool open(Ctx &ctx) {
     TRACE("Opening Snackis context");
     db::Trans trans(ctx);
     TRY(try_open);
@@ -17,6 +32,11 @@ namespace snackis {
     create_path(*get_val(ctx.settings.load_folder));
     create_path(*get_val(ctx.settings.save_folder));
     slurp(ctx);
+    remove_stale_indexes(ctx);
+
+    if (ctx.proc.rev.load() <= DB_STR_REV) { upgrade(ctx.settings); }
+    if (!db::upgrade(ctx)) { return false; }
+    set_sync(ctx.proc.write_loop, db::SyncPolicy(*get_val(ctx.settings.db_sync)));
 
     opt<UId> me_id = get_val(ctx.settings.whoami);
     if (!me_id) {
@@ -28,7 +48,9 @@ namespace snackis {
       log(ctx, "Initialized encryption-key");
     }
     
-    if (try_open.errors.empty()) { db::commit(trans, nullopt); }
+    if (!try_open.errors.empty()) { return false; }
+    db::commit(trans, nullopt);
+    return true;
   }
 
   void log(const Ctx &ctx, const str &msg) { db::log(ctx,msg); }
@@ -12,9 +12,10 @@ namespace snackis {
     Db db;
     Settings settings;
     Ctx(db::Proc &p, size_t max_buf);
+    ~Ctx();
   };
 
-  void open(Ctx &ctx);
+  bool open(Ctx &ctx);
   void log(const Ctx &ctx, const str &msg);
   UId whoamid(Ctx &ctx);
   Peer whoami(Ctx &ctx);
@@ -14,7 +14,11 @@
 #include "snackis/crypt/pub_key.hpp"
 #include "snackis/db/col.hpp"
 #include "snackis/db/ctx.hpp"
+#include "snackis/db/key_index.hpp"
+#include "snackis/db/query.hpp"
 #include "snackis/db/table.hpp"
+#include "snackis/db/tag_index.hpp"
+#include "snackis/db/text_index.hpp"
 
 namespace snackis {
   struct Db {
@@ -23,30 +27,41 @@ namespace snackis {
     db::Table<Invite, str> invites;
 	    
     db::Table<Peer, UId> peers;
-    db::Table<Peer, str, UId> peers_sort;
+    db::KeyIndex<Peer, str, UId> peers_sort;
+    db::TagIndex<Peer, UId> peers_tags;
+    db::TextIndex<Peer, UId> peers_text;
 
     db::Table<Script, UId> scripts;
-    db::Table<Script, str, Time, UId> scripts_sort;
+    db::KeyIndex<Script, str, Time, UId> scripts_sort;
+    db::TagIndex<Script, UId> scripts_tags;
     db::Schema<Script> scripts_share;
 
     db::Table<Feed, UId> feeds;
-    db::Table<Feed, Time, UId> feeds_sort;
+    db::KeyIndex<Feed, Time, UId> feeds_sort;
+    db::TextIndex<Feed, UId> feeds_text;
+    db::TagIndex<Feed, UId> feeds_tags;
     db::Schema<Feed> feeds_share;
 
     db::Table<Post, UId> posts;
-    db::Table<Post, Time, UId> posts_sort;
-    db::Table<Post, UId, Time, UId> feed_posts;
+    db::KeyIndex<Post, Time, UId> posts_sort;
+    db::KeyIndex<Post, UId, Time, UId> feed_posts;
+    db::TextIndex<Post, UId> posts_text;
+    db::TagIndex<Post, UId> posts_tags;
     db::Schema<Post> posts_share;
     
     db::Table<Msg, UId> inbox, outbox;
-    db::Table<Msg, Time, UId> inbox_sort;
+    db::KeyIndex<Msg, Time, UId> inbox_sort;
 
     db::Table<Project, UId> projects;
-    db::Table<Project, str, UId> projects_sort;
+    db::KeyIndex<Project, str, UId> projects_sort;
+    db::TextIndex<Project, UId> projects_text;
+    db::TagIndex<Project, UId> projects_tags;
     db::Schema<Project> projects_share;
 
     db::Table<Task, UId> tasks;
-    db::Table<Task, int64_t, Time, UId> tasks_sort;
+    db::KeyIndex<Task, int64_t, Time, UId> tasks_sort;
+    db::TextIndex<Task, UId> tasks_text;
+    db::TagIndex<Task, UId> tasks_tags;
     db::Schema<Task> tasks_share;
 
     Db(Ctx &ctx);
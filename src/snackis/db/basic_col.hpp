@@ -2,7 +2,9 @@
 #define SNACKIS_DB_BASIC_COL_HPP
 
 #include <iostream>
+#include <vector>
 
+#include "snackis/core/error.hpp"
 #include "snackis/core/str.hpp"
 #include "snackis/db/rec.hpp"
 
@@ -10,8 +12,13 @@ namespace snackis {
 namespace db {
   template <typename RecT>
   struct BasicCol {
+    using Cols = std::vector<const BasicCol<RecT> *>;
+
     const str name;
+    const size_t ord;
+
     BasicCol(const str &name);
+    virtual ~BasicCol();
     virtual void copy(RecT &dest, const RecT &src) const=0;
     virtual void copy(Rec<RecT> &dest, const RecT &src) const=0;
     virtual void copy(RecT &dest, const Rec<RecT> &src) const=0;
@@ -19,10 +26,35 @@ namespace db {
     virtual void set(RecT &dest, const Val &val) const=0;
     virtual Val read(std::istream &in) const=0;
     virtual void write(const Val &val, std::ostream &out) const=0;
+
+    static Cols &cols();
   };
 
   template <typename RecT>
-  BasicCol<RecT>::BasicCol(const str &name): name(name) { }
+  size_t add_ord(const BasicCol<RecT> &col) {
+    auto &cs(BasicCol<RecT>::cols());
+    auto fnd(std::find(cs.begin(), cs.end(), nullptr));
+    if (fnd != cs.end()) {
+      *fnd = &col;
+      return fnd - cs.begin();
+    }
+
+    CHECK(cs.size() < Rec<RecT>::MAX_COLS, _);
+    cs.push_back(&col);
+    return cs.size()-1;
+  }
+
+  template <typename RecT>
+  BasicCol<RecT>::BasicCol(const str &name): name(name), ord(add_ord(*this)) { }
+
+  template <typename RecT>
+  BasicCol<RecT>::~BasicCol() { cols()[ord] = nullptr; }
+
+  template <typename RecT>
+  typename BasicCol<RecT>::Cols &BasicCol<RecT>::cols() {
+    static Cols cs;
+    return cs;
+  }
 }}
 
 #endif
@@ -1,4 +1,5 @@
 #include "snackis/core/fmt.hpp"
+#include "snackis/core/int64_type.hpp"
 #include "snackis/db/ctx.hpp"
 #include "snackis/db/error.hpp"
 #include "snackis/db/basic_table.hpp"
@@ -9,4 +10,38 @@ namespace db {
     ctx(ctx),
     name(name),
     path(get_path(ctx, fmt("%0.tbl", name))) { }
+
+  static int cols_written_idx() {
+    static const int idx(std::ios_base::xalloc());
+    return idx;
+  }
+
+  bool cols_written(std::ios_base &out) {
+    return out.iword(cols_written_idx());
+  }
+  
+  void set_cols_written(std::ios_base &out, bool val) {
+    out.iword(cols_written_idx()) = val;
+  }
+
+  static int chunked_idx() {
+    static const int idx(std::ios_base::xalloc());
+    return idx;
+  }
+
+  bool chunked(std::ios_base &out) {
+    return out.iword(chunked_idx());
+  }
+  
+  void set_chunked(std::ios_base &out, bool val) {
+    out.iword(chunked_idx()) = val;
+  }
+
+  void write_chunk(BasicTable &tbl, Buf &buf, std::ostream &out) {
+    uint8_t op(TABLE_CHUNK);
+    out.write(reinterpret_cast<const char *>(&op), sizeof op);
+    const size_t len(encrypt_buf(*tbl.ctx.secret, buf));
+    int64_type.write(len, out);
+    out.write(reinterpret_cast<const char *>(&buf.data[0]), len);
+  }
 }}
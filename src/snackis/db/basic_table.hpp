@@ -1,12 +1,18 @@
 #ifndef SNACKIS_DB_BASIC_TABLE_HPP
 #define SNACKIS_DB_BASIC_TABLE_HPP
 
+#include <ios>
+
+#include "snackis/core/buf.hpp"
 #include "snackis/core/path.hpp"
 #include "snackis/core/str.hpp"
 
 namespace snackis {  
 namespace db {
   struct Ctx;
+
+  enum TableOp {TABLE_INSERT, TABLE_UPDATE, TABLE_ERASE, TABLE_COLS,
+		TABLE_SNAPSHOT, TABLE_DELTA, TABLE_BLOCKS, TABLE_CHUNK};
   
   struct BasicTable {
     Ctx &ctx;
@@ -15,8 +21,16 @@ namespace db {
     
     BasicTable(Ctx &ctx, const str &name);
     virtual void dump(std::ostream &out) = 0;
+    virtual size_t size() const = 0;
     virtual void slurp() = 0;
+    virtual int64_t compact(std::istream &in, std::ostream &out) = 0;
   };
+
+  bool cols_written(std::ios_base &out);
+  void set_cols_written(std::ios_base &out, bool val);
+  bool chunked(std::ios_base &out);
+  void set_chunked(std::ios_base &out, bool val);
+  void write_chunk(BasicTable &tbl, Buf &buf, std::ostream &out);
 }}
 
 #endif
@@ -4,6 +4,9 @@
 
 namespace snackis {
 namespace db {
+  Change::~Change()
+  { }
+  
   ChangeSet::ChangeSet(Ctx &ctx, const str &lbl, Changes &chs):
     ctx(ctx), label(lbl), committed_at(now())
   {
@@ -7,10 +7,13 @@
 
 namespace snackis {
 namespace db {
+  struct BasicTable;
   struct Ctx;
   
   struct Change {
-    virtual Path table_path() const = 0;
+    virtual ~Change();
+    virtual BasicTable &basic_table() const = 0;
+    virtual int64_t live_delta() const = 0;
     virtual void write(std::ostream &out) const = 0;
     virtual void apply(Ctx &ctx) const = 0;
     virtual void rollback() const = 0;
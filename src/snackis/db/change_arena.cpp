@@ -0,0 +1,34 @@
+#include <algorithm>
+
+#include "snackis/db/change_arena.hpp"
+
+namespace snackis {
+namespace db {
+  ChangeArena::ChangeArena():
+    pos(buf), end(buf + CHANGE_ARENA_SIZE), last(nullptr)
+  { }
+
+  ChangeArena::~ChangeArena() {
+    for (auto s(last); s; s = s->prev) { s->change->~Change(); }
+  }
+
+  static size_t align(size_t size) {
+    const size_t a(alignof(std::max_align_t));
+    return (size + a - 1) / a * a;
+  }
+  
+  void *alloc(ChangeArena &arena, size_t size) {
+    size = align(size);
+    
+    if (size > size_t(arena.end - arena.pos)) {
+      const size_t len(std::max(size, CHANGE_ARENA_SIZE));
+      arena.blocks.emplace_back(new unsigned char[len]);
+      arena.pos = arena.blocks.back().get();
+      arena.end = arena.pos + len;
+    }
+
+    auto p(arena.pos);
+    arena.pos += size;
+    return p;
+  }
+}}
@@ -0,0 +1,44 @@
+#ifndef SNACKIS_DB_CHANGE_ARENA_HPP
+#define SNACKIS_DB_CHANGE_ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "snackis/db/change.hpp"
+
+namespace snackis {
+namespace db {
+  const size_t CHANGE_ARENA_SIZE(4096);
+  
+  struct ChangeSlot {
+    ChangeSlot *prev;
+    Change *change;
+  };
+  
+  struct ChangeArena {
+    std::vector<std::unique_ptr<unsigned char[]>> blocks;
+    unsigned char *pos, *end;
+    ChangeSlot *last;
+    alignas(std::max_align_t) unsigned char buf[CHANGE_ARENA_SIZE];
+    
+    ChangeArena();
+    ~ChangeArena();
+  };
+
+  void *alloc(ChangeArena &arena, size_t size);
+
+  template <typename ChangeT, typename...ArgsT>
+  ChangeT *emplace(ChangeArena &arena, ArgsT &&...args) {
+    auto slot(static_cast<ChangeSlot *>(alloc(arena, sizeof(ChangeSlot))));
+    auto change(new (alloc(arena, sizeof(ChangeT)))
+		ChangeT(std::forward<ArgsT>(args)...));
+    slot->prev = arena.last;
+    slot->change = change;
+    arena.last = slot;
+    return change;
+  }
+}}
+
+#endif
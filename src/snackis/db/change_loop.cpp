@@ -6,8 +6,21 @@
 
 namespace snackis {
 namespace db {
+  ChangeNode::ChangeNode(Ctx *sender, const Changes &changes):
+    sender(sender), changes(changes), next(nullptr)
+  { }
+
+  ChangeNode::~ChangeNode() {
+    auto n(std::move(next_owner));
+
+    while (n && n.use_count() == 1) {
+      auto nn(std::move(n->next_owner));
+      n = std::move(nn);
+    }
+  }
+  
   ChangeLoop::ChangeLoop(Proc &p, size_t max_buf):
-    Loop(p, max_buf)
+    Loop(p, max_buf), head(std::make_shared<ChangeNode>(nullptr, Changes()))
   {
     start(*this);
   }
@@ -21,28 +34,14 @@ namespace db {
 
     switch (msg.type) {
     case MSG_CONNECT:
-      queues.emplace(ctx, Changes());
-      break;
-    case MSG_DISCONNECT:
-      queues.erase(ctx);
+      ctx->change_pos = head;
+      put(ctx->inbox, Msg(MSG_OK));
       break;
     case MSG_COMMIT: {
-      auto cs(get(msg, Msg::CHANGES));
-      
-      for (auto &q: queues) {
-	if (q.first != ctx) {
-	  std::copy(cs.begin(), cs.end(), std::back_inserter(q.second));
-	}
-      }
-
-      break;
-    }
-    case MSG_REFRESH: {
-      auto &q(queues[ctx]);
-      Msg msg(MSG_OK);
-      set(msg, Msg::CHANGES, q);
-      put(ctx->inbox, msg);
-      q.clear();
+      auto n(std::make_shared<ChangeNode>(ctx, get(msg, Msg::CHANGES)));
+      head->next_owner = n;
+      head->next.store(n.get(), std::memory_order_release);
+      head = n;
       break;
     }
     default:
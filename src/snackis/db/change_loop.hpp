@@ -1,19 +1,30 @@
 #ifndef SNACKIS_DB_CHANGE_LOOP_HPP
 #define SNACKIS_DB_CHANGE_LOOP_HPP
 
-#include <fstream>
-#include <map>
+#include <atomic>
+#include <memory>
 
-#include "snackis/core/path.hpp"
 #include "snackis/db/change.hpp"
 #include "snackis/db/loop.hpp"
 
 namespace snackis {
 namespace db {
   struct Proc;
+
+  struct ChangeNode {
+    Ctx *const sender;
+    const Changes changes;
+    std::shared_ptr<ChangeNode> next_owner;
+    std::atomic<const ChangeNode *> next;
+
+    ChangeNode(Ctx *sender, const Changes &changes);
+    ~ChangeNode();
+  };
+
+  using ChangePtr = std::shared_ptr<ChangeNode>;
   
   struct ChangeLoop: Loop {
-    std::map<Ctx *, Changes> queues;
+    ChangePtr head;
     
     ChangeLoop(Proc &p, size_t max_buf);
     ~ChangeLoop();
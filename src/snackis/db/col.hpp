@@ -44,7 +44,7 @@ namespace db {
   template <typename RecT, typename ValT>
   void Col<RecT, ValT>::copy(RecT &dest, const Rec<RecT> &src) const {
     auto fnd(src.find(this));
-    if (fnd != src.end()) { set(dest, fnd->second); }
+    if (fnd) { set(dest, *fnd); }
   }
 
   template <typename RecT, typename ValT>
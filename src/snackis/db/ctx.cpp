@@ -1,13 +1,17 @@
+#include <algorithm>
 #include <fstream>
 #include "snackis/ctx.hpp"
 #include "snackis/snackis.hpp"
+#include "snackis/core/parallel.hpp"
+#include "snackis/core/time.hpp"
 #include "snackis/crypt/error.hpp"
+#include "snackis/db/error.hpp"
 #include "snackis/db/proc.hpp"
 
 namespace snackis {
 namespace db {
   Ctx::Ctx(Proc &p, size_t max_buf):
-    proc(p), inbox(max_buf), trans(nullptr)
+    proc(p), inbox(max_buf), trans(nullptr), connected(true)
   { 
     Msg msg(MSG_CONNECT);
     set(msg, Msg::SENDER, this);
@@ -18,11 +22,15 @@ namespace db {
     CHECK(res->type == MSG_OK, _);
   }
 
-  Ctx::~Ctx() { 
+  Ctx::~Ctx() { disconnect(*this); }
+
+  void disconnect(Ctx &ctx) {
+    if (!ctx.connected) { return; }
     Msg msg(MSG_DISCONNECT);
-    set(msg, Msg::SENDER, this);
-    put(proc.inbox, msg);
-    get(inbox);
+    set(msg, Msg::SENDER, &ctx);
+    put(ctx.proc.inbox, msg);
+    get(ctx.inbox);
+    ctx.connected = false;
   }
 
   Path get_path(const Ctx &ctx, const str &fname) {
@@ -82,9 +90,32 @@ namespace db {
 
   void slurp(Ctx &ctx) {
     TRY(try_slurp);
+    std::vector<BasicTable *> tbls;
+    
     for (auto t: ctx.tables) {
-      if (path_exists(t.second->path)) { t.second->slurp(); }
+      if (path_exists(t.second->path)) { tbls.push_back(t.second); }
+    }
+
+    std::sort(tbls.begin(), tbls.end(), [](auto x, auto y) {
+	return path_size(x->path) > path_size(y->path);
+      });
+    
+    std::vector<int64_t> times(tbls.size(), 0);
+    auto start(pnow());
+
+    auto thread_cnt(parallel_for(tbls.size(), max_threads(), [&](size_t i) {
+	  auto tbl_start(pnow());
+	  tbls[i]->slurp();
+	  times[i] = usecs(pnow()-tbl_start);
+	}));
+    
+    for (size_t i(0); i < tbls.size(); i++) {
+      log(ctx, "Slurped %0 in %1ms: %2 records",
+	  tbls[i]->name, times[i] / 1000, tbls[i]->size());
     }
+
+    log(ctx, "Slurped %0 tables in %1ms using %2 threads",
+	tbls.size(), usecs(pnow()-start) / 1000, thread_cnt);
   }
 
   int64_t rewrite(Ctx &ctx) {
@@ -93,22 +124,36 @@ namespace db {
     set(msg, Msg::SENDER, &ctx);
     put(ctx.proc.inbox, msg);
     auto res(get(ctx.inbox));
-    return (res && res->type == MSG_OK) ? get(*res, Msg::RECLAIMED) : -1;
+
+    if (!res || res->type != MSG_OK) {
+      ERROR(Db, "Failed rewriting database");
+      return -1;
+    }
+    
+    return get(*res, Msg::RECLAIMED);
+  }
+
+  bool upgrade(Ctx &ctx) {
+    TRY(try_upgrade);
+    const int64_t rev(ctx.proc.rev.load());
+    if (rev >= DB_REV) { return true; }
+    
+    if (rewrite(ctx) < 0) { return false; }
+    log(ctx, "Upgraded database from revision %0 to %1", rev, DB_REV);
+    return true;
   }
 
   int64_t refresh(Ctx &ctx) {
     TRY(try_refresh);
-    Msg msg(MSG_REFRESH);
-    set(msg, Msg::SENDER, &ctx);
-    put(ctx.proc.inbox, msg);
-    auto res(get(ctx.inbox));
+    int64_t cnt(0);
     
-    if (res && res->type == MSG_OK) {
-      auto cs(get(*res, Msg::CHANGES));
-      for (auto &c: cs) { c->apply(ctx); }
-      return cs.size();
+    while (auto n = ctx.change_pos->next.load(std::memory_order_acquire)) {
+      ctx.change_pos = ctx.change_pos->next_owner;
+      if (n->sender == &ctx) { continue; }
+      for (auto &c: n->changes) { c->apply(ctx); }
+      cnt += n->changes.size();
     }
 
-    return -1;
+    return cnt;
   }
 }}
@@ -30,11 +30,14 @@ namespace db {
     std::map<str, BasicTable *> tables;
     Trans *trans;
     std::list<ChangeSet> undo_stack;
+    ChangePtr change_pos;
+    bool connected;
     
     Ctx(Proc &p, size_t max_buf);
     virtual ~Ctx();
   };
 
+  void disconnect(Ctx &ctx);
   Path get_path(const Ctx &ctx, const str &fname);
   Trans &get_trans(Ctx &ctx);
   bool pass_exists(const Ctx &ctx);
@@ -43,6 +46,7 @@ namespace db {
   void open(Ctx &ctx);
   void slurp(Ctx &ctx);
   int64_t rewrite(Ctx &ctx);
+  bool upgrade(Ctx &ctx);
   int64_t refresh(Ctx &ctx);
 
   template <typename...Args>
@@ -0,0 +1,158 @@
+#ifndef SNACKIS_DB_CURSOR_HPP
+#define SNACKIS_DB_CURSOR_HPP
+
+#include <cstddef>
+#include <memory>
+#include <tuple>
+
+namespace snackis {
+namespace db {
+  template <typename...KeyT>
+  struct Prefix {
+    const std::tuple<KeyT...> vals;
+    Prefix(const KeyT &...vals);
+  };
+
+  template <typename RecsT>
+  struct Cursor {
+    using Iter = typename RecsT::const_iterator;
+    using Val = typename RecsT::value_type;
+
+    const RecsT &recs;
+    Iter beg, end;
+    bool rev;
+    size_t max, cnt;
+
+    Cursor(const RecsT &recs);
+  };
+
+  template <typename...KeyT>
+  Prefix<KeyT...>::Prefix(const KeyT &...vals):
+    vals(vals...)
+  { }
+
+  template <typename...KeyT>
+  Prefix<KeyT...> prefix(const KeyT &...vals) {
+    return Prefix<KeyT...>(vals...);
+  }
+
+  template <size_t I, typename...KeyT, typename...PreT>
+  int compare_prefix(const std::tuple<KeyT...> &key, const Prefix<PreT...> &pre) {
+    if constexpr (I == sizeof...(PreT)) {
+      return 0;
+    } else {
+      auto &x(std::get<I>(key));
+      auto &y(std::get<I>(pre.vals));
+      if (x < y) { return -1; }
+      if (y < x) { return 1; }
+      return compare_prefix<I+1>(key, pre);
+    }
+  }
+
+  template <typename...KeyT, typename...PreT>
+  bool operator <(const std::tuple<KeyT...> &key, const Prefix<PreT...> &pre) {
+    return compare_prefix<0>(key, pre) < 0;
+  }
+
+  template <typename...KeyT, typename...PreT>
+  bool operator <(const Prefix<PreT...> &pre, const std::tuple<KeyT...> &key) {
+    return compare_prefix<0>(key, pre) > 0;
+  }
+
+  template <typename RecsT>
+  Cursor<RecsT>::Cursor(const RecsT &recs):
+    recs(recs), beg(recs.begin()), end(recs.end()), rev(false), max(0), cnt(0)
+  { }
+
+  template <typename RecsT>
+  const RecsT &get_recs(const RecsT &recs) { return recs; }
+
+  template <typename RecsT>
+  const RecsT &get_recs(const std::shared_ptr<const RecsT> &recs) { return *recs; }
+
+  template <typename TblT>
+  Cursor<typename TblT::Recs> scan(const TblT &tbl) {
+    return Cursor<typename TblT::Recs>(get_recs(tbl.recs));
+  }
+
+  template <typename RecsT>
+  Cursor<RecsT> &start_at(Cursor<RecsT> &cur, typename Cursor<RecsT>::Iter it) {
+    if (cur.beg != cur.recs.end() && (it == cur.recs.end() ||
+				      cur.beg->first < it->first)) {
+      cur.beg = it;
+    }
+
+    if (cur.end != cur.recs.end() &&
+	(cur.beg == cur.recs.end() || !(cur.beg->first < cur.end->first))) {
+      cur.beg = cur.end;
+    }
+
+    return cur;
+  }
+
+  template <typename RecsT, typename...PreT>
+  Cursor<RecsT> &from(Cursor<RecsT> &cur, const Prefix<PreT...> &pre) {
+    return start_at(cur, cur.recs.lower_bound(pre));
+  }
+
+  template <typename RecsT>
+  Cursor<RecsT> &stop_at(Cursor<RecsT> &cur, typename Cursor<RecsT>::Iter it) {
+    if (cur.end == cur.recs.end() ||
+	(it != cur.recs.end() && it->first < cur.end->first)) {
+      cur.end = it;
+    }
+
+    if (cur.end != cur.recs.end() &&
+	(cur.beg == cur.recs.end() || !(cur.beg->first < cur.end->first))) {
+      cur.beg = cur.end;
+    }
+
+    return cur;
+  }
+
+  template <typename RecsT, typename...PreT>
+  Cursor<RecsT> &until(Cursor<RecsT> &cur, const Prefix<PreT...> &pre) {
+    return stop_at(cur, cur.recs.upper_bound(pre));
+  }
+
+  template <typename RecsT, typename...PreT>
+  Cursor<RecsT> &before(Cursor<RecsT> &cur, const Prefix<PreT...> &pre) {
+    return stop_at(cur, cur.recs.lower_bound(pre));
+  }
+
+  template <typename TblT, typename...PreT>
+  Cursor<typename TblT::Recs> scan(const TblT &tbl, const Prefix<PreT...> &pre) {
+    auto cur(scan(tbl));
+    from(cur, pre);
+    until(cur, pre);
+    return cur;
+  }
+
+  template <typename RecsT>
+  Cursor<RecsT> &reverse(Cursor<RecsT> &cur) {
+    cur.rev = !cur.rev;
+    return cur;
+  }
+
+  template <typename RecsT>
+  Cursor<RecsT> &after(Cursor<RecsT> &cur, const typename RecsT::key_type &key) {
+    if (cur.rev) { return stop_at(cur, cur.recs.lower_bound(key)); }
+    return start_at(cur, cur.recs.upper_bound(key));
+  }
+
+  template <typename RecsT>
+  Cursor<RecsT> &limit(Cursor<RecsT> &cur, size_t max) {
+    cur.max = max;
+    return cur;
+  }
+
+  template <typename RecsT>
+  const typename Cursor<RecsT>::Val *fetch(Cursor<RecsT> &cur) {
+    if (cur.beg == cur.end || (cur.max && cur.cnt == cur.max)) { return nullptr; }
+    cur.cnt++;
+    if (cur.rev) { return &*(--cur.end); }
+    return &*(cur.beg++);
+  }
+}}
+
+#endif
@@ -32,7 +32,7 @@ namespace db {
   Key<RecT, KeyT...>::operator ()(const db::Rec<RecT> &rec) const {
     return map([this, &rec](auto c) {
 	auto fnd(rec.find(c));
-	return (fnd == rec.end()) ? c->type.null : c->type.from_val(fnd->second);
+	return fnd ? c->type.from_val(*fnd) : c->type.null;
       },
       *this);
   }
@@ -58,7 +58,7 @@ namespace db {
   void copy(const Key<RecT, KeyT...> &key, Rec<RecT> &dest, const Rec<RecT> &src) {
     for_each(key, [&dest, &src](auto c) {
 	auto found = src.find(c);
-	if (found != src.end()) { dest[c] = found->second; }
+	if (found) { dest[c] = *found; }
       });
   }
 }}
@@ -0,0 +1,72 @@
+#ifndef SNACKIS_DB_KEY_INDEX_HPP
+#define SNACKIS_DB_KEY_INDEX_HPP
+
+#include <functional>
+#include <map>
+
+#include "snackis/db/cursor.hpp"
+#include "snackis/db/key.hpp"
+#include "snackis/db/rec.hpp"
+
+namespace snackis {
+namespace db {
+  template <typename RecT>
+  struct BasicKeyIndex {
+    virtual ~BasicKeyIndex();
+    virtual void insert(const Rec<RecT> &rec) = 0;
+    virtual void erase(const Rec<RecT> &rec) = 0;
+    virtual void clear() = 0;
+    virtual void relink(const Rec<RecT> &rec);
+  };
+
+  template <typename RecT, typename...KeyT>
+  struct KeyIndex: BasicKeyIndex<RecT> {
+    using Key = db::Key<RecT, KeyT...>;
+    using Recs = std::map<typename Key::Type, const Rec<RecT> *, std::less<>>;
+
+    const Key key;
+    Recs recs;
+
+    KeyIndex(const Key &key);
+    void insert(const Rec<RecT> &rec) override;
+    void erase(const Rec<RecT> &rec) override;
+    void clear() override;
+    void relink(const Rec<RecT> &rec) override;
+  };
+
+  template <typename RecT>
+  BasicKeyIndex<RecT>::~BasicKeyIndex()
+  { }
+
+  template <typename RecT>
+  void BasicKeyIndex<RecT>::relink(const Rec<RecT> &rec)
+  { }
+
+  template <typename RecT, typename...KeyT>
+  KeyIndex<RecT, KeyT...>::KeyIndex(const Key &key):
+    key(key)
+  { }
+
+  template <typename RecT, typename...KeyT>
+  void KeyIndex<RecT, KeyT...>::insert(const Rec<RecT> &rec) {
+    recs[key(rec)] = &rec;
+  }
+
+  template <typename RecT, typename...KeyT>
+  void KeyIndex<RecT, KeyT...>::erase(const Rec<RecT> &rec) {
+    recs.erase(key(rec));
+  }
+
+  template <typename RecT, typename...KeyT>
+  void KeyIndex<RecT, KeyT...>::clear() {
+    recs.clear();
+  }
+
+  template <typename RecT, typename...KeyT>
+  void KeyIndex<RecT, KeyT...>::relink(const Rec<RecT> &rec) {
+    auto fnd(recs.find(key(rec)));
+    if (fnd != recs.end()) { fnd->second = &rec; }
+  }
+}}
+
+#endif
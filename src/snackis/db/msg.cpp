@@ -2,7 +2,9 @@
 
 namespace snackis {
 namespace db {
+  const MsgFld<Ack> Msg::ACK("ack");
   const MsgFld<Changes> Msg::CHANGES("changes");
+  const MsgFld<int64_t> Msg::POSTED_AT("posted_at");
   const MsgFld<int64_t> Msg::RECLAIMED("reclaimed");
   const MsgFld<Ctx *> Msg::SENDER("sender");
 
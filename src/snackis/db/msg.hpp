@@ -1,7 +1,9 @@
 #ifndef SNACKIS_DB_MSG_HPP
 #define SNACKIS_DB_MSG_HPP
 
+#include <future>
 #include <map>
+#include <memory>
 #include <variant>
 #include <vector>
 
@@ -28,14 +30,18 @@ namespace db {
   { }
 
   enum MsgType { MSG_CONNECT, MSG_DISCONNECT,
-		 MSG_COMMIT, MSG_REFRESH, MSG_REWRITE,
+		 MSG_COMMIT, MSG_REWRITE, MSG_CHECKPOINT,
+		 MSG_COMPACTED,
 		 MSG_OK, MSG_ERROR };
 
+  using Ack = std::shared_ptr<std::promise<bool>>;
+  
   struct Msg {
-    using Val = std::variant<int64_t, Ctx *, Changes>;
+    using Val = std::variant<int64_t, Ctx *, Changes, Ack>;
 
+    static const MsgFld<Ack> ACK;
     static const MsgFld<Changes> CHANGES;
-    static const MsgFld<int64_t> RECLAIMED;
+    static const MsgFld<int64_t> POSTED_AT, RECLAIMED;
     static const MsgFld<Ctx *> SENDER;
     
     const MsgType type;
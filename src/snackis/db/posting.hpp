@@ -0,0 +1,42 @@
+#ifndef SNACKIS_DB_POSTING_HPP
+#define SNACKIS_DB_POSTING_HPP
+
+#include <algorithm>
+#include <iterator>
+#include <set>
+#include <vector>
+
+namespace snackis {
+namespace db {
+  template <typename KeyT>
+  using Postings = std::set<KeyT>;
+
+  template <typename KeyT>
+  Postings<KeyT> intersect(std::vector<const Postings<KeyT> *> &in) {
+    if (in.empty()) { return Postings<KeyT>(); }
+
+    std::sort(in.begin(), in.end(),
+	      [](auto x, auto y) { return x->size() < y->size(); });
+    if (in.size() == 1) { return *in.front(); }
+    Postings<KeyT> out;
+    
+    for (auto &k: *in.front()) {
+      if (std::all_of(std::next(in.begin()), in.end(),
+		      [&k](auto ks) { return ks->count(k) > 0; })) {
+	out.insert(out.end(), k);
+      }
+    }
+
+    return out;
+  }
+
+  template <typename KeyT>
+  Postings<KeyT> intersect(std::vector<Postings<KeyT>> &in) {
+    if (in.size() == 1) { return std::move(in.front()); }
+    std::vector<const Postings<KeyT> *> ptrs;
+    for (auto &ks: in) { ptrs.push_back(&ks); }
+    return intersect(ptrs);
+  }
+}}
+
+#endif
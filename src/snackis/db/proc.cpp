@@ -1,3 +1,4 @@
+#include <vector>
 #include "snackis/snackis.hpp"
 #include "snackis/db/ctx.hpp"
 #include "snackis/db/error.hpp"
@@ -5,6 +6,24 @@
 
 namespace snackis {
 namespace db {
+  bool write_rev(Proc &proc, int64_t rev) {
+    const Path p(proc.path / "rev"), tmp_path(proc.path / "rev.tmp");
+    std::ofstream out;
+    out.open(tmp_path.string(), std::ios::out | std::ios::trunc | std::ios::binary);
+    out.write(reinterpret_cast<const char *>(&rev), sizeof rev);
+    out.close();
+    std::error_code e;
+    
+    if (!out.fail() && sync_path(tmp_path)) {
+      std::experimental::filesystem::rename(tmp_path, p, e);
+      if (!e && sync_dir(p)) { return true; }
+    }
+
+    remove_path(tmp_path);
+    ERROR(Db, fmt("Failed writing database revision: %0", p.string()));
+    return false;
+  }
+  
   static bool init_db_rev(Proc &proc) {
     const Path p(proc.path / "rev");
     
@@ -15,58 +34,92 @@ namespace db {
       in.read(reinterpret_cast<char *>(&rev), sizeof rev);
       in.close();
 
-      if (rev < DB_REV) {
+      if (rev < DB_STR_REV) {
 	ERROR(Db, fmt("This version of Snackis requires database revision #%0 to run",
-		      DB_REV));
+		      DB_STR_REV));
 	return false;
       }
 
+      proc.rev.store(rev);
       return true;
     }
     
-    std::ofstream out;
-    out.open(p.string(), std::ios::out | std::ios::trunc | std::ios::binary);
-    out.write(reinterpret_cast<const char *>(&DB_REV), sizeof(DB_REV));
-    out.close();
-
+    if (!write_rev(proc, DB_REV)) { return false; }
+    proc.rev.store(DB_REV);
     log(proc, "Initialized database, revision %0", DB_REV);
     return true;
   }
 
+  static void restore_backups(Proc &proc) {
+    std::vector<Path> baks;
+    
+    for (auto &f: PathIter(proc.path)) {
+      if (f.path().extension() == ".bak") { baks.push_back(f.path()); }
+    }
+
+    for (auto &bak: baks) {
+      Path p(bak);
+      p.replace_extension();
+      
+      if (proc.rev.load() < DB_REV || !path_exists(p)) {
+	std::error_code e;
+	std::experimental::filesystem::rename(bak, p, e);
+
+	if (e) {
+	  ERROR(Db, fmt("Failed restoring %0: %1", p.string(), e.message()));
+	} else {
+	  log(proc, "Restored %0 from interrupted rewrite", p.filename().string());
+	}
+      } else {
+	remove_path(bak);
+      }
+    }
+  }
+
   Proc::Proc(const Path &p, size_t max_buf):
     Loop(*this, max_buf),
     path(p),
+    rev(-1), commits(0), block_size(BLOCK_SIZE),
     write_loop(*this, max_buf),
     change_loop(*this, max_buf)
   {
     create_path(path);
-    init_db_rev(*this);
+    if (init_db_rev(*this)) { restore_backups(*this); }
     start(*this);
   }
 
   Proc::~Proc() {
     stop(*this);
   }
+
+  Int64Enc file_enc(const Proc &p) {
+    return (p.rev.load() <= DB_STR_REV) ? INT64_STR : INT64_VARINT;
+  }
+
+  void set_block_size(Proc &p, size_t size) {
+    p.block_size.store(size);
+  }
   
   void Proc::on_msg(const Msg &msg) {
     auto ctx(get(msg, Msg::SENDER));
     
     switch (msg.type) {
     case MSG_CONNECT:
-      put(ctx->inbox, Msg(MSG_OK));      
       put(change_loop.inbox, msg);
       break;
     case MSG_DISCONNECT:
-      put(ctx->inbox, Msg(MSG_OK));      
-      put(change_loop.inbox, msg);
+      put(write_loop.inbox, msg);
       break;
     case MSG_COMMIT:
       put(write_loop.inbox, msg);
       put(change_loop.inbox, msg);
+
+      if (++commits % CHECKPOINT_COMMITS == 0) {
+	Msg cmsg(MSG_CHECKPOINT);
+	set(cmsg, Msg::SENDER, ctx);
+	put(write_loop.inbox, cmsg);
+      }
       break;
-    case MSG_REFRESH:
-      put(change_loop.inbox, msg);
-      break;      
     case MSG_REWRITE:
       put(write_loop.inbox, msg);
       break;
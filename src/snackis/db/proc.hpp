@@ -1,16 +1,25 @@
 #ifndef SNACKIS_DB_PROC_HPP
 #define SNACKIS_DB_PROC_HPP
 
+#include <atomic>
+
+#include "snackis/core/int64_type.hpp"
 #include "snackis/core/path.hpp"
 #include "snackis/db/change_loop.hpp"
 #include "snackis/db/write_loop.hpp"
 
 namespace snackis {
 namespace db {
+  const int64_t CHECKPOINT_COMMITS(1000);
+  const size_t BLOCK_SIZE(64 * 1024);
+  
   struct Proc: Loop {
     using Logger = func<void (const str &)>;
 
     const Path path;
+    std::atomic<int64_t> rev;
+    int64_t commits;
+    std::atomic<size_t> block_size;
     WriteLoop write_loop;
     ChangeLoop change_loop;
     opt<Logger> logger;
@@ -20,6 +29,10 @@ namespace db {
     void on_msg(const Msg &msg) override;
   };
 
+  bool write_rev(Proc &proc, int64_t rev);
+  Int64Enc file_enc(const Proc &p);
+  void set_block_size(Proc &p, size_t size);
+
   template <typename...Args>
   void log(const Proc &p, const str &spec, const Args&...args) {
     if (p.logger) { (*p.logger)(fmt(spec, args...)); }
@@ -0,0 +1,225 @@
+#ifndef SNACKIS_DB_QUERY_HPP
+#define SNACKIS_DB_QUERY_HPP
+
+#include <iterator>
+#include <vector>
+
+#include "snackis/core/func.hpp"
+#include "snackis/core/opt.hpp"
+#include "snackis/core/str.hpp"
+#include "snackis/core/uid.hpp"
+#include "snackis/db/col.hpp"
+#include "snackis/db/cursor.hpp"
+#include "snackis/db/key_index.hpp"
+#include "snackis/db/posting.hpp"
+#include "snackis/db/table.hpp"
+#include "snackis/db/tag_index.hpp"
+#include "snackis/db/text_index.hpp"
+
+namespace snackis {
+namespace db {
+  const size_t QUERY_SCAN_RATIO(4);
+
+  template <typename RecT, typename...KeyT>
+  struct Query {
+    using Key = db::Key<RecT, KeyT...>;
+    using Keys = Postings<typename Key::Type>;
+    using Pred = func<bool (const Rec<RecT> &)>;
+
+    Table<RecT, KeyT...> &table;
+    opt<Keys> keys;
+    std::vector<Pred> preds;
+    size_t max;
+
+    Query(Table<RecT, KeyT...> &tbl);
+  };
+
+  template <typename RecT, typename...KeyT>
+  Query<RecT, KeyT...>::Query(Table<RecT, KeyT...> &tbl):
+    table(tbl), max(0)
+  { }
+
+  template <typename RecT, typename ValT>
+  ValT field(const Rec<RecT> &rec, const Col<RecT, ValT> &col) {
+    auto found(rec.find(&col));
+    return found ? col.type.from_val(*found) : col.type.null;
+  }
+
+  template <typename RecT, typename...KeyT>
+  Query<RecT, KeyT...> &filter(Query<RecT, KeyT...> &q,
+			       const typename Query<RecT, KeyT...>::Pred &pred) {
+    q.preds.push_back(pred);
+    return q;
+  }
+
+  template <typename RecT, typename...KeyT, typename ValT>
+  Query<RecT, KeyT...> &eq(Query<RecT, KeyT...> &q,
+			   const Col<RecT, ValT> &col,
+			   const ValT &val) {
+    return filter(q, [&col, val](auto &rec) { return field(rec, col) == val; });
+  }
+
+  template <typename RecT, typename...KeyT, typename ValT>
+  Query<RecT, KeyT...> &range(Query<RecT, KeyT...> &q,
+			      const Col<RecT, ValT> &col,
+			      const opt<ValT> &min,
+			      const opt<ValT> &max) {
+    if (!min && !max) { return q; }
+
+    return filter(q, [&col, min, max](auto &rec) {
+	auto v(field(rec, col));
+	return (!min || !(v < *min)) && (!max || !(*max < v));
+      });
+  }
+
+  template <typename RecT, typename...KeyT>
+  Query<RecT, KeyT...> &contains(Query<RecT, KeyT...> &q,
+				 const Col<RecT, str> &col,
+				 const str &sel) {
+    if (sel.empty()) { return q; }
+
+    return filter(q, [&col, sel](auto &rec) {
+	return find_ci(field(rec, col), sel) != str::npos;
+      });
+  }
+
+  template <typename RecT, typename...KeyT>
+  Query<RecT, KeyT...> &narrow(Query<RecT, KeyT...> &q,
+			       typename Query<RecT, KeyT...>::Keys &&keys) {
+    if (q.keys) {
+      std::vector<typename Query<RecT, KeyT...>::Keys> both;
+      both.push_back(std::move(*q.keys));
+      both.push_back(std::move(keys));
+      q.keys.emplace(intersect(both));
+    } else {
+      q.keys.emplace(std::move(keys));
+    }
+
+    return q;
+  }
+
+  template <typename RecT>
+  Query<RecT, UId> &id_prefix(Query<RecT, UId> &q, const str &sel) {
+    if (sel.empty()) { return q; }
+    typename Query<RecT, UId>::Keys keys;
+    auto cur(scan_id(q.table, sel));
+    while (auto it = fetch(cur)) { keys.insert(keys.end(), it->first); }
+    return narrow(q, std::move(keys));
+  }
+
+  template <typename RecT, typename...KeyT>
+  Query<RecT, KeyT...> &tagged(Query<RecT, KeyT...> &q,
+			       const TagIndex<RecT, KeyT...> &idx,
+			       const std::set<str> &tags) {
+    if (tags.empty()) { return q; }
+    return narrow(q, find(idx, tags));
+  }
+
+  template <typename RecT, typename...KeyT>
+  Query<RecT, KeyT...> &match(Query<RecT, KeyT...> &q,
+			      const TextIndex<RecT, KeyT...> &idx,
+			      const str &text) {
+    if (text_words(text).empty()) { return q; }
+    return narrow(q, find(idx, text));
+  }
+
+  template <typename RecT, typename...KeyT>
+  Query<RecT, KeyT...> &limit(Query<RecT, KeyT...> &q, size_t max) {
+    q.max = max;
+    return q;
+  }
+
+  template <typename RecT, typename...KeyT>
+  bool test(const Query<RecT, KeyT...> &q, const Rec<RecT> &rec) {
+    for (auto &p: q.preds) {
+      if (!p(rec)) { return false; }
+    }
+
+    return true;
+  }
+
+  template <typename RecT, typename...KeyT, typename RecsT, typename FnT>
+  size_t run_scan(const Query<RecT, KeyT...> &q, Cursor<RecsT> &cur, const FnT &fn) {
+    size_t cnt(0);
+
+    while (auto it = fetch(cur)) {
+      auto &rec(*it->second);
+      if (q.keys && !q.keys->count(q.table.key(rec))) { continue; }
+      if (!test(q, rec)) { continue; }
+      fn(rec);
+      cnt++;
+      if (q.max && cnt == q.max) { break; }
+    }
+
+    return cnt;
+  }
+
+  template <typename RecT, typename...KeyT, typename...SortT, typename FnT>
+  size_t run_keys(const Query<RecT, KeyT...> &q,
+		  const KeyIndex<RecT, SortT...> &idx,
+		  Cursor<typename KeyIndex<RecT, SortT...>::Recs> &cur,
+		  const FnT &fn) {
+    using Recs = typename KeyIndex<RecT, SortT...>::Recs;
+    if (cur.beg == cur.end) { return 0; }
+    Recs found;
+
+    for (auto &k: *q.keys) {
+      auto rec(find(q.table, k));
+      if (!rec || !test(q, *rec)) { continue; }
+      auto sk(idx.key(*rec));
+      if (sk < cur.beg->first) { continue; }
+      if (cur.end != cur.recs.end() && !(sk < cur.end->first)) { continue; }
+      found.emplace(sk, rec);
+
+      if (q.max && found.size() > q.max) {
+	found.erase(cur.rev ? found.begin() : std::prev(found.end()));
+      }
+    }
+
+    Cursor<Recs> out(found);
+    out.rev = cur.rev;
+    size_t cnt(0);
+
+    while (auto it = fetch(out)) {
+      fn(*it->second);
+      cnt++;
+    }
+
+    return cnt;
+  }
+
+  template <typename RecT, typename...KeyT, typename...SortT, typename FnT>
+  size_t run(const Query<RecT, KeyT...> &q,
+	     const KeyIndex<RecT, SortT...> &idx,
+	     Cursor<typename KeyIndex<RecT, SortT...>::Recs> cur,
+	     const FnT &fn) {
+    if (q.keys && q.keys->size() * QUERY_SCAN_RATIO < idx.recs.size()) {
+      return run_keys(q, idx, cur, fn);
+    }
+
+    return run_scan(q, cur, fn);
+  }
+
+  template <typename RecT, typename...KeyT, typename...SortT, typename FnT>
+  size_t run(const Query<RecT, KeyT...> &q,
+	     const KeyIndex<RecT, SortT...> &idx,
+	     const FnT &fn) {
+    return run(q, idx, scan(idx), fn);
+  }
+
+  template <typename RecT, typename...KeyT, typename...SortT, typename FnT>
+  size_t run(const Query<RecT, KeyT...> &q,
+	     const KeyIndex<RecT, SortT...> &idx,
+	     Cursor<typename KeyIndex<RecT, SortT...>::Recs> cur,
+	     opt<typename KeyIndex<RecT, SortT...>::Key::Type> &last,
+	     const FnT &fn) {
+    if (last) { after(cur, *last); }
+    
+    return run(q, idx, cur, [&idx, &last, &fn](auto &rec) {
+	last.emplace(idx.key(rec));
+	fn(rec);
+      });
+  }
+}}
+
+#endif
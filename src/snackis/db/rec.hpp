@@ -1,9 +1,11 @@
 #ifndef SNACKIS_DB_REC_HPP
 #define SNACKIS_DB_REC_HPP
 
-#include <map>
+#include <bitset>
 #include <string>
+#include <vector>
 
+#include "snackis/core/buf.hpp"
 #include "snackis/core/int64_type.hpp"
 #include "snackis/core/opt.hpp"
 #include "snackis/core/str_type.hpp"
@@ -22,10 +24,20 @@ namespace db {
   struct Schema;
 
   template <typename RecT>
-  struct Rec: std::map<const BasicCol<RecT> *, Val> {
+  struct Rec {
+    static const size_t MAX_COLS = 64;
+
+    std::vector<Val> slots;
+    std::bitset<MAX_COLS> used;
+
     Rec();
     Rec(const Schema<RecT> &scm, const RecT &src);
     Rec(const Schema<RecT> &scm, const Rec<RecT> &src);
+    const Val *find(const BasicCol<RecT> *col) const;
+    Val &operator [](const BasicCol<RecT> *col);
+    bool empty() const;
+    size_t size() const;
+    void clear();
   };
 
   template <typename RecT>
@@ -42,10 +54,43 @@ namespace db {
     copy(scm, *this, src);
   }
 
+  template <typename RecT>
+  const Val *Rec<RecT>::find(const BasicCol<RecT> *col) const {
+    return used.test(col->ord) ? &slots[col->ord] : nullptr;
+  }
+
+  template <typename RecT>
+  Val &Rec<RecT>::operator [](const BasicCol<RecT> *col) {
+    if (slots.size() <= col->ord) {
+      slots.resize(BasicCol<RecT>::cols().size());
+    }
+
+    used.set(col->ord);
+    return slots[col->ord];
+  }
+
+  template <typename RecT>
+  bool Rec<RecT>::empty() const { return used.none(); }
+
+  template <typename RecT>
+  size_t Rec<RecT>::size() const { return used.count(); }
+
+  template <typename RecT>
+  void Rec<RecT>::clear() { used.reset(); }
+
+  template <typename RecT, typename FnT>
+  void each(const Rec<RecT> &rec, const FnT &fn) {
+    auto &cols(BasicCol<RecT>::cols());
+
+    for (size_t i(0); i < rec.slots.size(); i++) {
+      if (rec.used.test(i)) { fn(*cols[i], rec.slots[i]); }
+    }
+  }
+
   template <typename RecT, typename ValT>
   opt<ValT> get(const Rec<RecT> &rec, const Col<RecT, ValT> &col) {
     auto found(rec.find(&col));
-    return (found == rec.end()) ? nullopt : opt<ValT>(get<ValT>(found->second));
+    return found ? opt<ValT>(col.type.from_val(*found)) : nullopt;
   }
 
   template <typename RecT, typename ValT>
@@ -55,7 +100,7 @@ namespace db {
 
   template <typename RecT>
   void copy(RecT &dest, const db::Rec<RecT> &src) {
-    for (auto &f: src) { f.first->set(dest, f.second); }
+    each(src, [&dest](auto &c, auto &v) { c.set(dest, v); });
   }
 
   template <typename RecT>
@@ -63,20 +108,46 @@ namespace db {
 	     std::ostream &out,
 	     opt<crypt::Secret> sec) {
     if (sec) {
-	Stream buf;
+	TmpBuf tmp(crypt::Secret::NONCE_SIZE);
+	std::ostream buf(&tmp.buf);
+	set_int64_enc(buf, get_int64_enc(out));
 	write(rec, buf, nullopt);
-	str data(buf.str());
-	const Data edata(encrypt(*sec, (unsigned char *)data.c_str(), data.size()));
-	int64_type.write(edata.size(), out);
-	out.write((char *)&edata[0], edata.size());
+	const size_t len(encrypt_buf(*sec, tmp.buf));
+	int64_type.write(len, out);
+	out.write((char *)&tmp.buf.data[0], len);
     } else {
       int64_type.write(rec.size(), out);
-    
-      for (auto f: rec) {
-	auto c(f.first);
-	str_type.write(c->name, out);
-	c->write(f.second, out);
-      }
+
+      each(rec, [&out](auto &c, auto &v) {
+	  str_type.write(c.name, out);
+	  c.write(v, out);
+	});
+    }
+  }
+
+  template <typename RecT>
+  void write_ords(const Rec<RecT> &rec,
+		  std::ostream &out,
+		  opt<crypt::Secret> sec) {
+    TmpBuf tmp(sec ? crypt::Secret::NONCE_SIZE : 0);
+    std::ostream buf(&tmp.buf);
+    set_int64_enc(buf, get_int64_enc(out));
+
+    if (sec) {
+	write_ords(rec, buf, nullopt);
+	const size_t len(encrypt_buf(*sec, tmp.buf));
+	int64_type.write(len, out);
+	out.write((char *)&tmp.buf.data[0], len);
+    } else {
+      int64_type.write(rec.size(), out);
+
+      each(rec, [&out, &tmp, &buf](auto &c, auto &v) {
+	  int64_type.write(c.ord, out);
+	  clear(tmp.buf);
+	  c.write(v, buf);
+	  int64_type.write(tmp.buf.size(), out);
+	  out.write((char *)tmp.buf.begin(), tmp.buf.size());
+	});
     }
   }
 }}
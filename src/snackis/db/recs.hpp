@@ -0,0 +1,135 @@
+#ifndef SNACKIS_DB_RECS_HPP
+#define SNACKIS_DB_RECS_HPP
+
+#include <functional>
+#include <map>
+#include <tuple>
+#include <utility>
+
+#include "snackis/core/uid_map.hpp"
+
+namespace snackis {
+namespace db {
+  template <typename KeyT, typename RecT>
+  struct Recs: std::map<KeyT, RecT, std::less<>> {
+    using std::map<KeyT, RecT, std::less<>>::map;
+  };
+
+  template <typename RecT>
+  struct Recs<std::tuple<UId>, RecT>: std::map<std::tuple<UId>, RecT, std::less<>> {
+    using Base = std::map<std::tuple<UId>, RecT, std::less<>>;
+    using key_type = typename Base::key_type;
+    using value_type = typename Base::value_type;
+    using iterator = typename Base::iterator;
+    using const_iterator = typename Base::const_iterator;
+
+    UIdMap<iterator> index;
+
+    Recs();
+    Recs(const Recs &src);
+    Recs &operator =(const Recs &src);
+
+    iterator find(const key_type &key);
+    const_iterator find(const key_type &key) const;
+
+    template <typename...ArgsT>
+    std::pair<iterator, bool> emplace(ArgsT &&...args);
+
+    template <typename...ArgsT>
+    iterator emplace_hint(const_iterator pos, ArgsT &&...args);
+
+    iterator insert(const_iterator pos, const value_type &val);
+    iterator erase(iterator pos);
+    size_t erase(const key_type &key);
+    void clear();
+  };
+
+  template <typename RecT>
+  void reindex(Recs<std::tuple<UId>, RecT> &recs) {
+    snackis::clear(recs.index);
+
+    for (auto i(recs.begin()); i != recs.end(); i++) {
+      snackis::insert(recs.index, std::get<0>(i->first), i);
+    }
+  }
+
+  template <typename RecT>
+  Recs<std::tuple<UId>, RecT>::Recs()
+  { }
+
+  template <typename RecT>
+  Recs<std::tuple<UId>, RecT>::Recs(const Recs &src):
+    Base(src)
+  {
+    reindex(*this);
+  }
+
+  template <typename RecT>
+  Recs<std::tuple<UId>, RecT> &
+  Recs<std::tuple<UId>, RecT>::operator =(const Recs &src) {
+    Base::operator =(src);
+    reindex(*this);
+    return *this;
+  }
+
+  template <typename RecT>
+  typename Recs<std::tuple<UId>, RecT>::iterator
+  Recs<std::tuple<UId>, RecT>::find(const key_type &key) {
+    auto fnd(snackis::find(index, std::get<0>(key)));
+    return fnd ? *fnd : this->end();
+  }
+
+  template <typename RecT>
+  typename Recs<std::tuple<UId>, RecT>::const_iterator
+  Recs<std::tuple<UId>, RecT>::find(const key_type &key) const {
+    return const_cast<Recs *>(this)->find(key);
+  }
+
+  template <typename RecT>
+  template <typename...ArgsT>
+  std::pair<typename Recs<std::tuple<UId>, RecT>::iterator, bool>
+  Recs<std::tuple<UId>, RecT>::emplace(ArgsT &&...args) {
+    auto res(Base::emplace(std::forward<ArgsT>(args)...));
+    if (res.second) { snackis::insert(index, std::get<0>(res.first->first), res.first); }
+    return res;
+  }
+
+  template <typename RecT>
+  template <typename...ArgsT>
+  typename Recs<std::tuple<UId>, RecT>::iterator
+  Recs<std::tuple<UId>, RecT>::emplace_hint(const_iterator pos, ArgsT &&...args) {
+    const size_t prev_size(this->size());
+    auto res(Base::emplace_hint(pos, std::forward<ArgsT>(args)...));
+    if (this->size() != prev_size) { snackis::insert(index, std::get<0>(res->first), res); }
+    return res;
+  }
+
+  template <typename RecT>
+  typename Recs<std::tuple<UId>, RecT>::iterator
+  Recs<std::tuple<UId>, RecT>::insert(const_iterator pos, const value_type &val) {
+    return emplace_hint(pos, val);
+  }
+
+  template <typename RecT>
+  typename Recs<std::tuple<UId>, RecT>::iterator
+  Recs<std::tuple<UId>, RecT>::erase(iterator pos) {
+    snackis::erase(index, std::get<0>(pos->first));
+    return Base::erase(pos);
+  }
+
+  template <typename RecT>
+  size_t Recs<std::tuple<UId>, RecT>::erase(const key_type &key) {
+    auto fnd(find(key));
+    if (fnd == this->end()) { return 0; }
+    erase(fnd);
+    return 1;
+  }
+
+  template <typename RecT>
+  void Recs<std::tuple<UId>, RecT>::clear() {
+    Base::clear();
+    snackis::clear(index);
+  }
+}}
+
+#endif
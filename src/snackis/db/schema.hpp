@@ -2,8 +2,10 @@
 #define SNACKIS_DB_SCHEMA_HPP
 
 #include <initializer_list>
+#include <map>
 #include <vector>
 
+#include "snackis/core/buf.hpp"
 #include "snackis/core/int64_type.hpp"
 #include "snackis/core/str.hpp"
 #include "snackis/core/str_type.hpp"
@@ -13,6 +15,9 @@
 
 namespace snackis {
 namespace db {
+  template <typename RecT>
+  using ColDict = std::vector<const BasicCol<RecT> *>;
+
   template <typename RecT>
   struct Schema {
     using Cols = std::initializer_list<const BasicCol<RecT> *>;
@@ -50,9 +55,9 @@ namespace db {
       auto xi = x.find(c);
       auto yi = y.find(c);
 
-      if (xi == x.end() && yi == y.end()) { continue; }
-      if (xi == x.end()) { return 1; }
-      if (yi == y.end()) { return -1; }
+      if (!xi && !yi) { continue; }
+      if (!xi) { return 1; }
+      if (!yi) { return -1; }
 
       if (*xi < *yi) { return -1; }
       if (*yi < *xi) { return 1; }
@@ -80,7 +85,7 @@ namespace db {
   void copy(const Schema<RecT> &scm, Rec<RecT> &dest, const Rec<RecT> &src) {
     for (auto c: scm.cols) {
       auto found = src.find(c);
-      if (found != src.end()) { dest[c] = found->second; }
+      if (found) { dest[c] = *found; }
     }
   }
 
@@ -90,11 +95,13 @@ namespace db {
 	    Rec<RecT> &rec,
 	    opt<crypt::Secret> sec) {
     if (sec) {
-      int64_t size(int64_type.read(in));
-      Data edata(size);
-      in.read((char *)&edata[0], size);
-      const Data ddata(decrypt(*sec, (unsigned char *)&edata[0], size));
-      Stream buf(str(ddata.begin(), ddata.end()));
+      const int64_t size(int64_type.read(in));
+      TmpBuf tmp;
+      unsigned char *edata(tmp.buf.reserve(size));
+      in.read((char *)edata, size);
+      SpanBuf ddata(edata+crypt::Secret::NONCE_SIZE, decrypt_buf(*sec, edata, size));
+      std::istream buf(&ddata);
+      set_int64_enc(buf, get_int64_enc(in));
       read(scm, buf, rec, nullopt);
     } else {
       int64_t cnt(int64_type.read(in));
@@ -110,6 +117,62 @@ namespace db {
       }
     }
   }  
+
+  template <typename RecT>
+  void read_ords(const ColDict<RecT> &dict,
+		 std::istream &in,
+		 Rec<RecT> &rec,
+		 opt<crypt::Secret> sec) {
+    if (sec) {
+      const int64_t size(int64_type.read(in));
+      TmpBuf tmp;
+      unsigned char *edata(tmp.buf.reserve(size));
+      in.read((char *)edata, size);
+      SpanBuf ddata(edata+crypt::Secret::NONCE_SIZE, decrypt_buf(*sec, edata, size));
+      std::istream buf(&ddata);
+      set_int64_enc(buf, get_int64_enc(in));
+      read_ords(dict, buf, rec, nullopt);
+    } else {
+      int64_t cnt(int64_type.read(in));
+
+      for (int64_t i=0; i<cnt; i++) {
+	const int64_t ord(int64_type.read(in));
+	const int64_t len(int64_type.read(in));
+	auto c((ord >= 0 && ord < int64_t(dict.size())) ? dict[ord] : nullptr);
+
+	if (c) {
+	  rec[c] = c->read(in);
+	} else {
+	  in.ignore(len);
+	}
+      }
+    }
+  }
+
+  template <typename RecT>
+  void read_cols(const Schema<RecT> &scm, std::istream &in, ColDict<RecT> &dict) {
+    int64_t cnt(int64_type.read(in));
+    dict.clear();
+    
+    for (int64_t i=0; i<cnt; i++) {
+      const int64_t ord(int64_type.read(in));
+      const str cname(str_type.read(in));
+      if (ord < 0 || ord >= Rec<RecT>::MAX_COLS) { continue; }
+      if (int64_t(dict.size()) <= ord) { dict.resize(ord+1, nullptr); }
+      auto found(scm.col_lookup.find(cname));
+      dict[ord] = (found == scm.col_lookup.end()) ? nullptr : found->second;
+    }
+  }
+
+  template <typename RecT>
+  void write_cols(const Schema<RecT> &scm, std::ostream &out) {
+    int64_type.write(scm.cols.size(), out);
+
+    for (auto c: scm.cols) {
+      int64_type.write(c->ord, out);
+      str_type.write(c->name, out);
+    }
+  }
 }}
 
 #endif
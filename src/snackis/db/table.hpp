@@ -1,23 +1,32 @@
 #ifndef SNACKIS_DB_TABLE_HPP
 #define SNACKIS_DB_TABLE_HPP
 
+#include <atomic>
 #include <cstdint>
+#include <memory>
 #include <set>
 
+#include "snackis/core/buf.hpp"
 #include "snackis/core/data.hpp"
 #include "snackis/core/fmt.hpp"
 #include "snackis/core/func.hpp"
 #include "snackis/core/int64_type.hpp"
 #include "snackis/core/opt.hpp"
+#include "snackis/core/parallel.hpp"
 #include "snackis/core/str_type.hpp"
 #include "snackis/core/type.hpp"
 #include "snackis/core/stream.hpp"
+#include "snackis/core/time.hpp"
+#include "snackis/core/uid.hpp"
 #include "snackis/crypt/secret.hpp"
 #include "snackis/db/change.hpp"
 #include "snackis/db/ctx.hpp"
+#include "snackis/db/cursor.hpp"
 #include "snackis/db/error.hpp"
 #include "snackis/db/index.hpp"
+#include "snackis/db/key_index.hpp"
 #include "snackis/db/rec.hpp"
+#include "snackis/db/recs.hpp"
 #include "snackis/db/trans.hpp"
 
 namespace snackis {  
@@ -29,14 +38,14 @@ namespace db {
   struct Table: Index<RecT> {
     using Key = db::Key<RecT, KeyT...>;
     using Cols = std::initializer_list<const BasicCol<RecT> *>;
-    using Recs = std::map<typename Key::Type, Rec<RecT>>;
+    using Recs = db::Recs<typename Key::Type, Rec<RecT>>;
     using RecIter = typename Recs::iterator;
     using OnInsert = func<void (Rec<RecT> &)>;
     using OnUpdate = func<void (const Rec<RecT> &, Rec<RecT> &)>;
     
     const Key key;
-    std::set<Index<RecT> *> indexes;
-    Recs recs;
+    std::set<BasicKeyIndex<RecT> *> indexes;
+    std::shared_ptr<const Recs> recs;
     std::vector<OnInsert> on_insert;
     std::vector<OnUpdate> on_update;
     
@@ -51,10 +60,10 @@ namespace db {
     bool erase(const Rec<RecT> &rec) override;
 
     void dump(std::ostream &out) override;
+    size_t size() const override;
     void slurp() override;
+    int64_t compact(std::istream &in, std::ostream &out) override;
   };
-    
-  enum TableOp {TABLE_INSERT, TABLE_UPDATE, TABLE_ERASE};
 
   template <typename RecT, typename...KeyT>
   struct TableChange: Change {
@@ -63,7 +72,8 @@ namespace db {
     const Rec<RecT> rec;
 
     TableChange(TableOp op, Table<RecT, KeyT...> &table, const Rec<RecT> &rec);
-    Path table_path() const override;
+    BasicTable &basic_table() const override;
+    int64_t live_delta() const override;
     virtual void write(std::ostream &out) const override;
   };
 
@@ -80,7 +90,7 @@ namespace db {
     const Rec<RecT> prev_rec;
     Update(Table<RecT, KeyT...> &table,
 	   const Rec<RecT> &rec,
-	   const Rec<RecT> &prev_rec);    
+	   Rec<RecT> &&prev_rec);    
     void apply(Ctx &ctx) const override;
     void rollback() const override;
     void undo() const override;
@@ -98,8 +108,8 @@ namespace db {
   template <typename RecT, typename...KeyT>
   opt<RecT> load(Table<RecT, KeyT...> &tbl, RecT &rec) {
     auto k(tbl.key(rec));
-    auto it(tbl.recs.find(k));
-    if (it == tbl.recs.end()) { return nullopt; }
+    auto it(tbl.recs->find(k));
+    if (it == tbl.recs->end()) { return nullopt; }
     copy(tbl, rec, it->second);
     return rec;
   }
@@ -107,8 +117,8 @@ namespace db {
   template <typename RecT, typename...KeyT>
   opt<Rec<RecT>> load(Table<RecT, KeyT...> &tbl, Rec<RecT> &rec) {
     auto k(tbl.key(rec));
-    auto it(tbl.recs.find(k));
-    if (it == tbl.recs.end()) { return nullopt; }
+    auto it(tbl.recs->find(k));
+    if (it == tbl.recs->end()) { return nullopt; }
     copy(tbl, rec, it->second);
     return rec;
   }
@@ -116,8 +126,8 @@ namespace db {
   template <typename RecT, typename...KeyT>
   const Rec<RecT> *find(Table<RecT, KeyT...> &tbl,
 			const typename Key<RecT, KeyT...>::Type &key) {
-    auto it(tbl.recs.find(key));
-    if (it == tbl.recs.end()) { return nullptr; }
+    auto it(tbl.recs->find(key));
+    if (it == tbl.recs->end()) { return nullptr; }
     return &it->second;
   }
 
@@ -134,8 +144,8 @@ namespace db {
   template <typename RecT, typename...KeyT>
   const Rec<RecT> &get(Table<RecT, KeyT...> &tbl,
 		       const typename Key<RecT, KeyT...>::Type &key) {
-    auto it(tbl.recs.find(key));
-    CHECK(it != tbl.recs.end(), _);
+    auto it(tbl.recs->find(key));
+    CHECK(it != tbl.recs->end(), _);
     return it->second;
   }
 
@@ -149,21 +159,86 @@ namespace db {
     return get(tbl, tbl.key(rec));
   }
 
-  template <typename RecT, typename...KeyT>
-  bool insert(Table<RecT, KeyT...> &tbl, const Rec<RecT> &rec) {
-    TRACE(fmt("Inserting into table: %0", tbl.name));
-    auto k(tbl.key(rec));
-    auto it(tbl.recs.find(k));
-    if (it != tbl.recs.end()) { return false; }
+  template <typename RecT>
+  Cursor<typename Table<RecT, UId>::Recs> scan_id(const Table<RecT, UId> &tbl,
+						  const str &prefix) {
+    auto cur(scan(tbl));
+    auto rng(parse_uid_prefix(prefix));
+    
+    if (!rng) {
+      cur.beg = cur.end;
+      return cur;
+    }
+    
+    from(cur, db::prefix(rng->first));
+    until(cur, db::prefix(rng->second));
+    return cur;
+  }
 
+  template <typename RecT, typename...KeyT>
+  void reindex(Table<RecT, KeyT...> &tbl) {
     for (auto idx: tbl.indexes) {
-      insert(*idx, rec);
+      idx->clear();
+      for (auto &rec: *tbl.recs) { idx->insert(rec.second); }
+    }
+  }
+
+  template <typename RecT, typename...KeyT>
+  void relink(Table<RecT, KeyT...> &tbl) {
+    for (auto &rec: *tbl.recs) {
+      for (auto idx: tbl.indexes) { idx->relink(rec.second); }
+    }
+  }
+
+  template <typename RecT, typename...KeyT>
+  typename Table<RecT, KeyT...>::Recs &detach(Table<RecT, KeyT...> &tbl) {
+    using Recs = typename Table<RecT, KeyT...>::Recs;
+    
+    if (tbl.recs.use_count() > 1) {
+      tbl.recs = std::make_shared<Recs>(*tbl.recs);
+      relink(tbl);
+    } else {
+      std::atomic_thread_fence(std::memory_order_acquire);
     }
 
-    it = tbl.recs.emplace(k, db::Rec<RecT>()).first;
+    return const_cast<Recs &>(*tbl.recs);
+  }
+
+  template <typename RecT, typename...KeyT>
+  typename Table<RecT, KeyT...>::RecIter
+  insert_rec(Table<RecT, KeyT...> &tbl,
+	     const typename Key<RecT, KeyT...>::Type &key,
+	     const Rec<RecT> &rec) {
+    auto it(detach(tbl).emplace(key, rec).first);
+    for (auto idx: tbl.indexes) { idx->insert(it->second); }
+    return it;
+  }
+
+  template <typename RecT, typename...KeyT>
+  void erase_rec(Table<RecT, KeyT...> &tbl,
+		 typename Table<RecT, KeyT...>::RecIter it) {
+    for (auto idx: tbl.indexes) { idx->erase(it->second); }
+    detach(tbl).erase(it);
+  }
+
+  template <typename RecT, typename...KeyT>
+  bool erase_rec(Table<RecT, KeyT...> &tbl,
+		 const typename Key<RecT, KeyT...>::Type &key) {
+    if (tbl.recs->find(key) == tbl.recs->end()) { return false; }
+    erase_rec(tbl, detach(tbl).find(key));
+    return true;
+  }
+
+  template <typename RecT, typename...KeyT>
+  bool insert(Table<RecT, KeyT...> &tbl, const Rec<RecT> &rec) {
+    TRACE(fmt("Inserting into table: %0", tbl.name));
+    auto k(tbl.key(rec));
+    if (tbl.recs->find(k) != tbl.recs->end()) { return false; }
+    auto it(detach(tbl).emplace(k, db::Rec<RecT>()).first);
     copy(tbl, it->second, rec);
     for (auto e: tbl.on_insert) { e(it->second); }
-    log_change(get_trans(tbl.ctx), new Insert<RecT, KeyT...>(tbl, it->second));
+    for (auto idx: tbl.indexes) { idx->insert(it->second); }
+    log_change<Insert<RecT, KeyT...>>(get_trans(tbl.ctx), tbl, it->second);
     return true;
   }
 
@@ -178,37 +253,52 @@ namespace db {
 	     const Rec<RecT> &rec,
 	     const typename Key<RecT, KeyT...>::Type &key) {
     TRACE(fmt("Updating table: %0", tbl.name));
-    auto it(tbl.recs.find(key));
+    auto fnd(tbl.recs->find(key));
 
-    if (it == tbl.recs.end() || compare(tbl, rec, it->second) == 0) {
+    if (fnd == tbl.recs->end() || compare(tbl, rec, fnd->second) == 0) {
       return nullopt;
     }
-    
+
+    auto &recs(detach(tbl));
+    auto it(recs.find(key));
     auto prev(it->second);
     auto rec_key(tbl.key(rec));
+    for (auto idx: tbl.indexes) { idx->erase(prev); }
     
     if (rec_key == key) {
       it->second.clear();
       copy(tbl, it->second, rec);
     } else {
-      tbl.recs.erase(it);
-      it = tbl.recs.emplace(rec_key, db::Rec<RecT>()).first;
+      recs.erase(it);
+      it = recs.emplace(rec_key, db::Rec<RecT>()).first;
       copy(tbl, it->second, rec);
     }
 
+    for (auto idx: tbl.indexes) { idx->insert(it->second); }
     return make_pair(it, prev);
   }
   
+  template <typename RecT, typename...KeyT>
+  bool merge_rec(Table<RecT, KeyT...> &tbl, const Rec<RecT> &delta) {
+    auto key(tbl.key(delta));
+    auto fnd(tbl.recs->find(key));
+    if (fnd == tbl.recs->end()) { return false; }
+    Rec<RecT> rec(fnd->second);
+    each(delta, [&rec](auto &c, auto &v) { rec[&c] = v; });
+    update_rec(tbl, rec, key);
+    return true;
+  }
+  
   template <typename RecT, typename...KeyT>
   bool update(Table<RecT, KeyT...> &tbl,
 	      const Rec<RecT> &rec,
 	      const typename Key<RecT, KeyT...>::Type &key) {
     auto res(update_rec(tbl, rec, key));
     if (!res) { return false; }
-    auto [it, prev] = *res;
-    for (auto idx: tbl.indexes) { update(*idx, rec, prev); }
+    auto &[it, prev] = *res;
     for (auto e: tbl.on_update) { e(prev, it->second); }
-    log_change(get_trans(tbl.ctx), new Update<RecT, KeyT...>(tbl, it->second, prev));
+    log_change<Update<RecT, KeyT...>>(get_trans(tbl.ctx), tbl, it->second,
+				      std::move(prev));
     return true;
   }
 
@@ -244,11 +334,10 @@ namespace db {
   bool erase(Table<RecT, KeyT...> &tbl,
 	     const typename Key<RecT, KeyT...>::Type &key) {
     TRACE(fmt("Erasing from table: %0", tbl.name));
-    auto it(tbl.recs.find(key));
-    if (it == tbl.recs.end()) { return false; }
-    log_change(get_trans(tbl.ctx), new Erase<RecT, KeyT...>(tbl, it->second));
-    for (auto idx: tbl.indexes) { erase(*idx, it->second); }
-    tbl.recs.erase(it);
+    if (tbl.recs->find(key) == tbl.recs->end()) { return false; }
+    auto it(detach(tbl).find(key));
+    log_change<Erase<RecT, KeyT...>>(get_trans(tbl.ctx), tbl, it->second);
+    erase_rec(tbl, it);
     return true;
   }
 
@@ -267,58 +356,363 @@ namespace db {
     return erase(tbl, tbl.key(rec));
   }
 
+  template <typename RecT, typename...KeyT>
+  void write_cols(Table<RecT, KeyT...> &tbl, std::ostream &out) {
+    uint8_t op(TABLE_COLS);
+    out.write(reinterpret_cast<const char *>(&op), sizeof op);
+    write_cols(dynamic_cast<Schema<RecT> &>(tbl), out);
+    set_cols_written(out, true);
+  }
+  
   template <typename RecT, typename...KeyT>
   void write(Table<RecT, KeyT...> &tbl, TableOp _op,
 	     const Rec<RecT> &rec,
 	     std::ostream &out) {
+    if (!cols_written(out)) { write_cols(tbl, out); }
     uint8_t op(_op);
     out.write(reinterpret_cast<const char *>(&op), sizeof op);
-    write(rec, out, tbl.ctx.secret);
+    write_ords(rec, out, chunked(out) ? opt<crypt::Secret>() : tbl.ctx.secret);
   }
 
   template <typename RecT, typename...KeyT>
-  void dump(Table<RecT, KeyT...> &tbl, std::ostream &out) {    
-    for (auto &rec: tbl.recs) {
-      write(tbl, TABLE_INSERT, rec.second, out);
+  opt<Rec<RecT>> get_delta(Table<RecT, KeyT...> &tbl,
+			   const Rec<RecT> &rec,
+			   const Rec<RecT> &prev) {
+    Rec<RecT> out;
+    copy(tbl.key, out, rec);
+    
+    for (auto c: tbl.cols) {
+      auto x(rec.find(c));
+      auto y(prev.find(c));
+      if (!x && y) { return nullopt; }
+      if (!x || (y && !(*x < *y) && !(*y < *x))) { continue; }
+      out[c] = *x;
     }
+
+    if (out.size() >= rec.size()) { return nullopt; }
+    return out;
   }
 
   template <typename RecT, typename...KeyT>
-  void slurp(Table<RecT, KeyT...> &tbl, std::istream &in) {    
-    while (true) {
-      uint8_t op;
-      in.read(reinterpret_cast<char *>(&op), sizeof op);
+  void write_snapshot(Table<RecT, KeyT...> &tbl,
+		      const typename Table<RecT, KeyT...>::Recs &recs,
+		      std::ostream &out) {    
+    write_cols(tbl, out);
+    const size_t block_size(tbl.ctx.proc.block_size.load());
+    uint8_t op(block_size ? TABLE_BLOCKS : TABLE_SNAPSHOT);
+    out.write(reinterpret_cast<const char *>(&op), sizeof op);
+    int64_type.write(recs.size(), out);
+
+    if (!block_size) {
+      for (auto &rec: recs) {
+	write_ords(rec.second, out, tbl.ctx.secret);
+      }
+
+      return;
+    }
 
+    auto &sec(tbl.ctx.secret);
+    TmpBuf data, pdata(sec ? crypt::Secret::NONCE_SIZE : 0);
+    std::ostream buf(&data.buf);
+    set_int64_enc(buf, get_int64_enc(out));
+    int64_t cnt(0), packed(0), unpacked(0);
+    
+    auto write_block([&]() {
+	const size_t len(data.buf.size()), max_len(compress_bound(len));
+	clear(pdata.buf, pdata.buf.head);
+	const size_t clen(compress(data.buf.begin(), len,
+				   pdata.buf.reserve(max_len), max_len));
+
+	if (!clen) {
+	  ERROR(Db, fmt("Failed packing: %0", tbl.name));
+	  out.setstate(std::ios::failbit);
+	  return false;
+	}
+	
+	pdata.buf.commit(clen);
+	const size_t plen(sec ? encrypt_buf(*sec, pdata.buf) : pdata.buf.size());
+	int64_type.write(cnt, out);
+	int64_type.write(len, out);
+	int64_type.write(plen, out);
+	out.write(reinterpret_cast<const char *>(&pdata.buf.data[0]), plen);
+	packed += plen;
+	unpacked += len;
+	clear(data.buf);
+	cnt = 0;
+	return true;
+      });
+    
+    for (auto &rec: recs) {
+      write_ords(rec.second, buf, nullopt);
+      cnt++;
+      if (data.buf.size() >= block_size && !write_block()) { return; }
+    }
+
+    if (cnt && !write_block()) { return; }
+
+    if (unpacked) {
+      log(tbl.ctx, "Packed %0 from %1 to %2 bytes", tbl.name, unpacked, packed);
+    }
+  }
+
+  template <typename RecT, typename...KeyT>
+  void dump(Table<RecT, KeyT...> &tbl, std::ostream &out) {    
+    write_snapshot(tbl, *tbl.recs, out);
+  }
+
+  const size_t SLURP_BATCH(1024), SLURP_BLOCKS(64);
+  
+  template <typename RecT>
+  struct SlurpFrame {
+    uint8_t op;
+    std::shared_ptr<const ColDict<RecT>> dict;
+    Data edata;
+    Rec<RecT> rec;
+    int64_t size;
+    std::vector<uint8_t> ops;
+    std::vector<Rec<RecT>> recs;
+
+    SlurpFrame(uint8_t op, const std::shared_ptr<const ColDict<RecT>> &dict);
+  };
+
+  template <typename RecT>
+  SlurpFrame<RecT>::SlurpFrame(uint8_t op,
+			       const std::shared_ptr<const ColDict<RecT>> &dict):
+    op(op), dict(dict), size(0)
+  { }
+  
+  template <typename RecT, typename...KeyT>
+  void replay(Table<RecT, KeyT...> &tbl,
+	      typename Table<RecT, KeyT...>::Recs &recs,
+	      uint8_t op,
+	      const Rec<RecT> &rec) {
+    switch (op) {
+    case TABLE_INSERT:
+      recs.emplace(tbl.key(rec), rec);
+      break;
+    case TABLE_UPDATE: {
+      auto k(tbl.key(rec));
+      recs.erase(k);
+      recs.emplace(k, rec);
+      break;
+    }
+    case TABLE_ERASE:
+      recs.erase(tbl.key(rec));
+      break;
+    case TABLE_SNAPSHOT:
+      recs.emplace_hint(recs.end(), tbl.key(rec), rec);
+      break;
+    case TABLE_DELTA: {
+      auto fnd(recs.find(tbl.key(rec)));
+      
+      if (fnd == recs.end()) {
+	log(tbl.ctx, fmt("Missing delta record: %0", tbl.name));
+	break;
+      }
+
+      auto &dest(fnd->second);
+      each(rec, [&dest](auto &c, auto &v) { dest[&c] = v; });
+      break;
+    }
+    default:
+      log(tbl.ctx, fmt("Invalid table operation: %0", op));
+    }
+  }
+  
+  template <typename RecT, typename...KeyT>
+  TableStats slurp(Table<RecT, KeyT...> &tbl,
+		   std::istream &in,
+		   typename Table<RecT, KeyT...>::Recs &recs) {    
+    auto &sec(tbl.ctx.secret);
+    const Int64Enc enc(get_int64_enc(in));
+    std::shared_ptr<const ColDict<RecT>> dict;
+    std::vector<SlurpFrame<RecT>> frames;
+    int64_t snapshot_left(0), snapshot_end(0);
+    uint8_t snapshot_op(TABLE_SNAPSHOT);
+    size_t blocks(0);
+    TableStats stats;
+
+    auto read_rec([&](const SlurpFrame<RecT> &f, std::istream &in, Rec<RecT> &rec) {
+	if (f.dict) {
+	  read_ords(*f.dict, in, rec, nullopt);
+	} else {
+	  read(tbl, in, rec, nullopt);
+	}
+      });
+    
+    auto unpack([&](SlurpFrame<RecT> &f) {
+	const unsigned char *pdata(&f.edata[0]);
+	size_t plen(f.edata.size());
+	
+	if (sec) {
+	  plen = decrypt_buf(*sec, &f.edata[0], plen);
+	  pdata += crypt::Secret::NONCE_SIZE;
+	}
+
+	TmpBuf tmp;
+	unsigned char *data(tmp.buf.reserve(f.size));
+	
+	if (!uncompress(pdata, plen, data, f.size)) {
+	  ERROR(Db, fmt("Failed unpacking: %0", tbl.name));
+	  f.recs.clear();
+	  return;
+	}
+	
+	SpanBuf ddata(data, f.size);
+	std::istream buf(&ddata);
+	set_int64_enc(buf, enc);
+	for (auto &rec: f.recs) { read_rec(f, buf, rec); }
+      });
+    
+    auto unchunk([&](SlurpFrame<RecT> &f) {
+	SpanBuf ddata(&f.edata[crypt::Secret::NONCE_SIZE],
+		      decrypt_buf(*sec, &f.edata[0], f.edata.size()));
+	std::istream buf(&ddata);
+	set_int64_enc(buf, enc);
+	uint8_t op;
+	
+	while (buf.read(reinterpret_cast<char *>(&op), sizeof op)) {
+	  f.ops.push_back(op);
+	  f.recs.emplace_back();
+	  read_rec(f, buf, f.recs.back());
+	}
+      });
+    
+    auto replay_frames([&]() {
+	if (sec || blocks) {
+	  parallel_for(frames.size(), max_threads(), [&](size_t i) {
+	      auto &f(frames[i]);
+
+	      if (f.op == TABLE_BLOCKS) {
+		unpack(f);
+	      } else if (f.op == TABLE_CHUNK) {
+		unchunk(f);
+	      } else if (sec) {
+		SpanBuf ddata(&f.edata[crypt::Secret::NONCE_SIZE],
+			      decrypt_buf(*sec, &f.edata[0], f.edata.size()));
+		std::istream buf(&ddata);
+		set_int64_enc(buf, enc);
+		read_rec(f, buf, f.rec);
+	      }
+	    });
+	}
+	
+	for (auto &f: frames) {
+	  if (f.op == TABLE_BLOCKS) {
+	    for (auto &rec: f.recs) { replay(tbl, recs, TABLE_SNAPSHOT, rec); }
+	  } else if (f.op == TABLE_CHUNK) {
+	    for (size_t i(0); i < f.ops.size(); i++) {
+	      replay(tbl, recs, f.ops[i], f.recs[i]);
+	    }
+
+	    stats.entries += f.ops.size();
+	    stats.tail += f.ops.size();
+	  } else {
+	    replay(tbl, recs, f.op, f.rec);
+	  }
+	}
+	
+	frames.clear();
+	blocks = 0;
+      });
+    
+    while (true) {
+      if (frames.size() == SLURP_BATCH || blocks == SLURP_BLOCKS) { replay_frames(); }
+      uint8_t op(snapshot_op);
+      if (!snapshot_left) { in.read(reinterpret_cast<char *>(&op), sizeof op); }
+      
       if (in.eof()) {
 	in.clear();
+	stats.bytes = in.tellg();
 	break;
       }
-
+      
       if (in.fail()) {
 	in.clear();
 	ERROR(Db, fmt("Failed reading: %0", tbl.name));
+	break;
+      }
+      
+      if (op == TABLE_COLS) {
+	auto d(std::make_shared<ColDict<RecT>>());
+	read_cols(tbl, in, *d);
+	dict = d;
+	continue;
+      }
+      
+      if ((op == TABLE_SNAPSHOT || op == TABLE_BLOCKS) && !snapshot_left) {
+	replay_frames();
+	recs.clear();
+	snapshot_op = op;
+	snapshot_left = int64_type.read(in);
+	stats.entries = stats.tail = 0;
+	if (!snapshot_left) { snapshot_end = in.tellg(); }
+	continue;
       }
-            
-      Rec<RecT> rec;
-      read(tbl, in, rec, tbl.ctx.secret);
 
-      switch (op) {
-      case TABLE_INSERT:
-	tbl.recs.emplace(tbl.key(rec), rec);
-	break;
-      case TABLE_UPDATE: {
-	auto k(tbl.key(rec));
-	tbl.recs.erase(k);
-	tbl.recs.emplace(k, rec);
-	break;
+      if (op == TABLE_CHUNK) {
+	if (!sec) {
+	  ERROR(Db, fmt("Encrypted chunk in: %0", tbl.name));
+	  break;
+	}
+	
+	frames.emplace_back(op, dict);
+	auto &f(frames.back());
+	f.edata.resize(int64_type.read(in));
+	in.read(reinterpret_cast<char *>(&f.edata[0]), f.edata.size());
+	continue;
       }
-      case TABLE_ERASE:
-	tbl.recs.erase(tbl.key(rec));
-	break;
-      default:
-	log(tbl.ctx, fmt("Invalid table operation: %0", op));
+      
+      const bool snapshot(snapshot_left);
+
+      if (op == TABLE_BLOCKS) {
+	frames.emplace_back(op, dict);
+	auto &f(frames.back());
+	const int64_t cnt(std::min(int64_type.read(in), snapshot_left));
+	f.recs.resize(cnt);
+	f.size = int64_type.read(in);
+	f.edata.resize(int64_type.read(in));
+	in.read(reinterpret_cast<char *>(&f.edata[0]), f.edata.size());
+	snapshot_left -= cnt;
+	stats.entries += cnt;
+	stats.packed_bytes += f.edata.size();
+	stats.unpacked_bytes += f.size;
+	blocks++;
+	if (!snapshot_left) { snapshot_end = in.tellg(); }
+	continue;
+      }
+      
+      if (snapshot) {
+	snapshot_left--;
+      } else {
+	stats.tail++;
+      }
+
+      stats.entries++;
+      frames.emplace_back(op, dict);
+      auto &f(frames.back());
+      
+      if (sec) {
+	f.edata.resize(int64_type.read(in));
+	in.read(reinterpret_cast<char *>(&f.edata[0]), f.edata.size());
+      } else if (dict) {
+	read_ords(*dict, in, f.rec, nullopt);
+      } else {
+	read(tbl, in, f.rec, nullopt);
       }
+
+      if (snapshot && !snapshot_left) { snapshot_end = in.tellg(); }
     }
+
+    replay_frames();
+    stats.live = recs.size();
+    stats.tail_bytes = stats.bytes - snapshot_end;
+    return stats;
+  }
+
+  template <typename RecT, typename...KeyT>
+  TableStats slurp(Table<RecT, KeyT...> &tbl, std::istream &in) {
+    return slurp(tbl, in, detach(tbl));
   }
 
   template <typename RecT, typename...KeyT>
@@ -332,14 +726,33 @@ namespace db {
       return;
     }
 
-    slurp(tbl, f);
+    set_int64_enc(f, file_enc(tbl.ctx.proc));
+    const auto start(pnow());
+    auto stats(slurp(tbl, f));
     f.close();
+    reindex(tbl);
+    init_stats(tbl.ctx.proc.write_loop, tbl, stats);
+
+    if (stats.packed_bytes) {
+      log(tbl.ctx, "Loaded %0 in %1us, unpacked %2 to %3 bytes",
+	  tbl.name, usecs(pnow()-start), stats.packed_bytes, stats.unpacked_bytes);
+    } else {
+      log(tbl.ctx, "Loaded %0 in %1us", tbl.name, usecs(pnow()-start));
+    }
+  }
+
+  template <typename RecT, typename...KeyT>
+  int64_t compact(Table<RecT, KeyT...> &tbl, std::istream &in, std::ostream &out) {
+    typename Table<RecT, KeyT...>::Recs recs;
+    slurp(tbl, in, recs);
+    write_snapshot(tbl, recs, out);
+    return recs.size();
   }
 
   template <typename RecT, typename...KeyT>
   void copy(Table<RecT, KeyT...> &dest, const Table<RecT, KeyT...> &src) {
-    std::copy(src.recs.begin(), src.recs.end(),
-	      std::inserter(dest.recs, dest.recs.end()));
+    for (auto idx: dest.indexes) { idx->clear(); }
+    dest.recs = src.recs;
   }
   
   template <typename RecT, typename...KeyT>
@@ -348,7 +761,8 @@ namespace db {
 			      const Key &key,
 			      const Schema<RecT> &cols):
     Index<RecT>(ctx, name, cols),
-    key(key)
+    key(key),
+    recs(std::make_shared<Recs>())
   {
     for_each(key, [this](auto c) { add(*this, *c); });
     ctx.tables.emplace(name, this);
@@ -377,9 +791,17 @@ namespace db {
   template <typename RecT, typename...KeyT>
   void Table<RecT, KeyT...>::dump(std::ostream &out) { db::dump(*this, out); }
 
+  template <typename RecT, typename...KeyT>
+  size_t Table<RecT, KeyT...>::size() const { return recs->size(); }
+
   template <typename RecT, typename...KeyT>
   void Table<RecT, KeyT...>::slurp() { db::slurp(*this); }
 
+  template <typename RecT, typename...KeyT>
+  int64_t Table<RecT, KeyT...>::compact(std::istream &in, std::ostream &out) {
+    return db::compact(*this, in, out);
+  }
+
   template <typename RecT, typename...KeyT>
   TableChange<RecT, KeyT...>::TableChange(TableOp op,
 					  Table<RecT, KeyT...> &table,
@@ -388,8 +810,20 @@ namespace db {
   { }
 
   template <typename RecT, typename...KeyT>
-  Path TableChange<RecT, KeyT...>::table_path() const {
-    return table.path;
+  BasicTable &TableChange<RecT, KeyT...>::basic_table() const {
+    return table;
+  }
+
+  template <typename RecT, typename...KeyT>
+  int64_t TableChange<RecT, KeyT...>::live_delta() const {
+    switch (op) {
+    case TABLE_INSERT:
+      return 1;
+    case TABLE_ERASE:
+      return -1;
+    default:
+      return 0;
+    }
   }
 
   template <typename RecT, typename...KeyT>
@@ -405,12 +839,12 @@ namespace db {
   template <typename RecT, typename...KeyT>
   void Insert<RecT, KeyT...>::apply(Ctx &ctx) const {
     auto &tbl(get_table<RecT, KeyT...>(ctx, this->table.name));
-    tbl.recs.emplace(tbl.key(this->rec), this->rec);
+    insert_rec(tbl, tbl.key(this->rec), this->rec);
   }
 
   template <typename RecT, typename...KeyT>
   void Insert<RecT, KeyT...>::rollback() const {
-    this->table.recs.erase(this->table.key(this->rec));
+    erase_rec(this->table, this->table.key(this->rec));
   }
 
   template <typename RecT, typename...KeyT>
@@ -421,15 +855,28 @@ namespace db {
   template <typename RecT, typename...KeyT>
   Update<RecT, KeyT...>::Update(Table<RecT, KeyT...> &table,
 				const Rec<RecT> &rec,
-				const Rec<RecT> &prev_rec):
+				Rec<RecT> &&prev_rec):
     TableChange<RecT, KeyT...>(TABLE_UPDATE, table, rec),
-    prev_rec(prev_rec)
+    prev_rec(std::move(prev_rec))
   { }
 
+  template <typename RecT, typename...KeyT>
+  opt<Rec<RecT>> get_delta(const Update<RecT, KeyT...> &upd) {
+    auto &tbl(upd.table);
+    if (tbl.key(upd.rec) != tbl.key(upd.prev_rec)) { return nullopt; }
+    return get_delta(tbl, upd.rec, upd.prev_rec);
+  }
+  
   template <typename RecT, typename...KeyT>
   void Update<RecT, KeyT...>::apply(Ctx &ctx) const {
     auto &tbl(get_table<RecT, KeyT...>(ctx, this->table.name));
-    update_rec(tbl, this->rec, tbl.key(this->prev_rec));
+    auto delta(get_delta(*this));
+    
+    if (delta) {
+      merge_rec(tbl, *delta);
+    } else {
+      update_rec(tbl, this->rec, tbl.key(this->prev_rec));
+    }
   }
 
   template <typename RecT, typename...KeyT>
@@ -445,7 +892,13 @@ namespace db {
   template <typename RecT, typename...KeyT>
   void Update<RecT, KeyT...>::write(std::ostream &out) const {
     if (this->table.key(this->rec) == this->table.key(this->prev_rec)) {
-      TableChange<RecT, KeyT...>::write(out);
+      auto delta(get_delta(*this));
+      
+      if (delta) {
+	db::write(this->table, TABLE_DELTA, *delta, out);
+      } else {
+	TableChange<RecT, KeyT...>::write(out);
+      }
     } else {
       db::write(this->table, TABLE_ERASE, this->prev_rec, out);
       db::write(this->table, TABLE_INSERT, this->rec, out);
@@ -460,12 +913,12 @@ namespace db {
   template <typename RecT, typename...KeyT>
   void Erase<RecT, KeyT...>::apply(Ctx &ctx) const {
     auto &tbl(get_table<RecT, KeyT...>(ctx, this->table.name));
-    tbl.recs.erase(tbl.key(this->rec));
+    erase_rec(tbl, tbl.key(this->rec));
   }
 
   template <typename RecT, typename...KeyT>
   void Erase<RecT, KeyT...>::rollback() const {
-    this->table.recs.emplace(this->table.key(this->rec), this->rec);
+    insert_rec(this->table, this->table.key(this->rec), this->rec);
   }
 
   template <typename RecT, typename...KeyT>
@@ -0,0 +1,91 @@
+#ifndef SNACKIS_DB_TAG_INDEX_HPP
+#define SNACKIS_DB_TAG_INDEX_HPP
+
+#include <functional>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "snackis/core/str.hpp"
+#include "snackis/db/key.hpp"
+#include "snackis/db/key_index.hpp"
+#include "snackis/db/posting.hpp"
+
+namespace snackis {
+namespace db {
+  template <typename RecT, typename...KeyT>
+  struct TagIndex: BasicKeyIndex<RecT> {
+    using Key = db::Key<RecT, KeyT...>;
+    using Keys = Postings<typename Key::Type>;
+    using Tags = std::map<str, Keys, std::less<>>;
+
+    const Key key;
+    const Col<RecT, std::set<str>> &col;
+    Tags tags;
+
+    TagIndex(const Key &key, const Col<RecT, std::set<str>> &col);
+    void insert(const Rec<RecT> &rec) override;
+    void erase(const Rec<RecT> &rec) override;
+    void clear() override;
+  };
+
+  template <typename RecT, typename...KeyT>
+  TagIndex<RecT, KeyT...>::TagIndex(const Key &key,
+				    const Col<RecT, std::set<str>> &col):
+    key(key), col(col)
+  { }
+
+  template <typename RecT, typename...KeyT>
+  std::set<str> rec_tags(const TagIndex<RecT, KeyT...> &idx, const Rec<RecT> &rec) {
+    auto ts(get(rec, idx.col));
+    return ts ? *ts : std::set<str>();
+  }
+
+  template <typename RecT, typename...KeyT>
+  void TagIndex<RecT, KeyT...>::insert(const Rec<RecT> &rec) {
+    auto k(key(rec));
+    for (auto &t: rec_tags(*this, rec)) { tags[t].insert(k); }
+  }
+
+  template <typename RecT, typename...KeyT>
+  void TagIndex<RecT, KeyT...>::erase(const Rec<RecT> &rec) {
+    auto k(key(rec));
+
+    for (auto &t: rec_tags(*this, rec)) {
+      auto found(tags.find(t));
+      if (found == tags.end()) { continue; }
+      found->second.erase(k);
+      if (found->second.empty()) { tags.erase(found); }
+    }
+  }
+
+  template <typename RecT, typename...KeyT>
+  void TagIndex<RecT, KeyT...>::clear() {
+    tags.clear();
+  }
+
+  template <typename RecT, typename...KeyT>
+  const typename TagIndex<RecT, KeyT...>::Keys &
+  find(const TagIndex<RecT, KeyT...> &idx, const str &tag) {
+    static const typename TagIndex<RecT, KeyT...>::Keys empty;
+    auto found(idx.tags.find(tag));
+    return (found == idx.tags.end()) ? empty : found->second;
+  }
+
+  template <typename RecT, typename...KeyT>
+  typename TagIndex<RecT, KeyT...>::Keys
+  find(const TagIndex<RecT, KeyT...> &idx, const std::set<str> &tags) {
+    using Keys = typename TagIndex<RecT, KeyT...>::Keys;
+    std::vector<const Keys *> hits;
+
+    for (auto &t: tags) {
+      auto &ks(find(idx, t));
+      if (ks.empty()) { return Keys(); }
+      hits.push_back(&ks);
+    }
+
+    return intersect(hits);
+  }
+}}
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef SNACKIS_DB_TEXT_INDEX_HPP
+#define SNACKIS_DB_TEXT_INDEX_HPP
+
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "snackis/core/str.hpp"
+#include "snackis/db/key.hpp"
+#include "snackis/db/key_index.hpp"
+#include "snackis/db/posting.hpp"
+
+namespace snackis {
+namespace db {
+  template <typename RecT, typename...KeyT>
+  struct TextIndex: BasicKeyIndex<RecT> {
+    using Key = db::Key<RecT, KeyT...>;
+    using Keys = Postings<typename Key::Type>;
+    using Words = std::map<str, Keys, std::less<>>;
+
+    const Key key;
+    const std::vector<const Col<RecT, str> *> cols;
+    Words words;
+
+    TextIndex(const Key &key, std::initializer_list<const Col<RecT, str> *> cols);
+    void insert(const Rec<RecT> &rec) override;
+    void erase(const Rec<RecT> &rec) override;
+    void clear() override;
+  };
+
+  template <typename RecT, typename...KeyT>
+  TextIndex<RecT, KeyT...>::TextIndex(const Key &key,
+				      std::initializer_list<const Col<RecT, str> *> cols):
+    key(key), cols(cols)
+  { }
+
+  template <typename RecT, typename...KeyT>
+  std::set<str> rec_words(const TextIndex<RecT, KeyT...> &idx, const Rec<RecT> &rec) {
+    std::set<str> out;
+
+    for (auto c: idx.cols) {
+      auto v(get(rec, *c));
+      if (!v) { continue; }
+      auto ws(text_words(*v));
+      out.insert(ws.begin(), ws.end());
+    }
+
+    return out;
+  }
+
+  template <typename RecT, typename...KeyT>
+  void TextIndex<RecT, KeyT...>::insert(const Rec<RecT> &rec) {
+    auto k(key(rec));
+    for (auto &w: rec_words(*this, rec)) { words[w].insert(k); }
+  }
+
+  template <typename RecT, typename...KeyT>
+  void TextIndex<RecT, KeyT...>::erase(const Rec<RecT> &rec) {
+    auto k(key(rec));
+
+    for (auto &w: rec_words(*this, rec)) {
+      auto found(words.find(w));
+      if (found == words.end()) { continue; }
+      found->second.erase(k);
+      if (found->second.empty()) { words.erase(found); }
+    }
+  }
+
+  template <typename RecT, typename...KeyT>
+  void TextIndex<RecT, KeyT...>::clear() {
+    words.clear();
+  }
+
+  template <typename RecT, typename...KeyT>
+  const typename TextIndex<RecT, KeyT...>::Keys *
+  find_prefix(const TextIndex<RecT, KeyT...> &idx,
+	      const str &prefix,
+	      std::deque<typename TextIndex<RecT, KeyT...>::Keys> &buf) {
+    auto beg(idx.words.lower_bound(prefix)), end(beg);
+    
+    while (end != idx.words.end() &&
+	   end->first.compare(0, prefix.size(), prefix) == 0) {
+      end++;
+    }
+
+    if (beg == end) { return nullptr; }
+    if (std::next(beg) == end) { return &beg->second; }
+    buf.emplace_back();
+    auto &out(buf.back());
+    for (auto i(beg); i != end; i++) { out.insert(i->second.begin(), i->second.end()); }
+    return &out;
+  }
+
+  template <typename RecT, typename...KeyT>
+  typename TextIndex<RecT, KeyT...>::Keys
+  find_prefix(const TextIndex<RecT, KeyT...> &idx, const str &prefix) {
+    std::deque<typename TextIndex<RecT, KeyT...>::Keys> buf;
+    auto found(find_prefix(idx, prefix, buf));
+    return found ? *found : typename TextIndex<RecT, KeyT...>::Keys();
+  }
+
+  template <typename RecT, typename...KeyT>
+  typename TextIndex<RecT, KeyT...>::Keys
+  find(const TextIndex<RecT, KeyT...> &idx, const str &query) {
+    using Keys = typename TextIndex<RecT, KeyT...>::Keys;
+    std::deque<Keys> buf;
+    std::vector<const Keys *> hits;
+
+    for (auto &w: text_words(query)) {
+      auto found(find_prefix(idx, w, buf));
+      if (!found) { return Keys(); }
+      hits.push_back(found);
+    }
+
+    return intersect(hits);
+  }
+}}
+
+#endif
@@ -1,3 +1,4 @@
+#include "snackis/core/time.hpp"
 #include "snackis/db/change.hpp"
 #include "snackis/db/ctx.hpp"
 #include "snackis/db/trans.hpp"
@@ -16,28 +17,40 @@ namespace db {
     ctx.trans = super;
   }
   
-  void log_change(Trans &trans, Change *change) {
-    trans.changes.push_back(std::shared_ptr<Change>(change));
-  }
-
   static void clear(Trans &trans) {
     trans.changes.clear();
+    trans.arena.reset();
   }
   
-  void commit(Trans &trans, const opt<str> &lbl) {
-    if (trans.changes.empty()) { return; }
-
+  static void commit(Trans &trans, const opt<str> &lbl, const opt<Ack> &ack) {
     Ctx &ctx(trans.ctx);
     Msg msg(MSG_COMMIT);
     set(msg, Msg::SENDER, &ctx);
     set(msg, Msg::CHANGES, trans.changes);
+    set(msg, Msg::POSTED_AT, int64_t(usecs(pnow().time_since_epoch())));
+    if (ack) { set(msg, Msg::ACK, *ack); }
     put(ctx.proc.inbox, msg);
     
-    if (lbl) {
-      ctx.undo_stack.emplace_back(ctx, *lbl, trans.changes);
+    if (lbl) { ctx.undo_stack.emplace_back(ctx, *lbl, trans.changes); }
+    clear(trans);
+  }
+  
+  void commit(Trans &trans, const opt<str> &lbl) {
+    if (trans.changes.empty()) { return; }
+    commit(trans, lbl, nullopt);
+  }
+
+  std::future<bool> commit_durable(Trans &trans, const opt<str> &lbl) {
+    Ack ack(std::make_shared<std::promise<bool>>());
+    auto out(ack->get_future());
+
+    if (trans.changes.empty()) {
+      ack->set_value(true);
     } else {
-      clear(trans);
+      commit(trans, lbl, ack);
     }
+    
+    return out;
   }
   
   void rollback(Trans &trans) {
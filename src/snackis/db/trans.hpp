@@ -1,8 +1,11 @@
 #ifndef SNACKIS_DB_TRANS_HPP
 #define SNACKIS_DB_TRANS_HPP
 
+#include <future>
+#include <memory>
 #include <vector>
 #include "snackis/db/change.hpp"
+#include "snackis/db/change_arena.hpp"
 #include "snackis/db/ctx.hpp"
 
 namespace snackis {
@@ -11,12 +14,20 @@ namespace db {
     Ctx &ctx;
     Trans *super;
     Changes changes;
+    std::shared_ptr<ChangeArena> arena;
     Trans(Ctx &ctx);
     ~Trans();
   };
 
-  void log_change(Trans &trans, Change *change);
+  template <typename ChangeT, typename...ArgsT>
+  void log_change(Trans &trans, ArgsT &&...args) {
+    if (!trans.arena) { trans.arena = std::make_shared<ChangeArena>(); }
+    auto c(emplace<ChangeT>(*trans.arena, std::forward<ArgsT>(args)...));
+    trans.changes.emplace_back(trans.arena, c);
+  }
+
   void commit(Trans &trans, const opt<str> &lbl);
+  std::future<bool> commit_durable(Trans &trans, const opt<str> &lbl);
   void rollback(Trans &trans);
 }}
 
@@ -1,3 +1,9 @@
+#include <algorithm>
+#include "snackis/snackis.hpp"
+#include "snackis/core/buf.hpp"
+#include "snackis/core/int64_type.hpp"
+#include "snackis/core/stream.hpp"
+#include "snackis/core/time.hpp"
 #include "snackis/db/basic_table.hpp"
 #include "snackis/db/ctx.hpp"
 #include "snackis/db/error.hpp"
@@ -6,14 +12,49 @@
 
 namespace snackis {
 namespace db {
+  WriteStats::WriteStats():
+    commits(0), batches(0), syncs(0), max_batch(0), total_usecs(0), max_usecs(0),
+    compactions(0), compacted_bytes(0), written_bytes(0)
+  { }
+
+  TableStats::TableStats():
+    table(nullptr), entries(0), live(0), tail(0), bytes(0), tail_bytes(0),
+    packed_bytes(0), unpacked_bytes(0)
+  { }
+
+  Compaction::Compaction(BasicTable &tbl, uintmax_t offset):
+    table(tbl),
+    tmp_path(tbl.path.string() + ".tmp"),
+    offset(offset),
+    tail_entries(0), live(0),
+    ok(false), done(false)
+  { }
+  
   WriteLoop::WriteLoop(Proc &p, size_t max_buf):
-    Loop(p, max_buf)
+    Loop(p, max_buf), sync(SYNC_BATCH)
   {
     start(*this);
   }
 
+  static void drop_compaction(WriteLoop &lp, WriteLoop::Compactions::iterator fnd) {
+    remove_path(fnd->second->tmp_path);
+    lp.compactions.erase(fnd);
+  }
+  
+  static void cancel_compaction(WriteLoop &lp, const Path &p) {
+    auto fnd(lp.compactions.find(p));
+    if (fnd == lp.compactions.end()) { return; }
+    auto &c(*fnd->second);
+    if (c.thread.joinable()) { c.thread.join(); }
+    drop_compaction(lp, fnd);
+  }
+  
   WriteLoop::~WriteLoop() {
     stop(*this);
+    
+    while (!compactions.empty()) {
+      cancel_compaction(*this, compactions.begin()->first);
+    }
   }
   
   static std::ofstream &get_file(WriteLoop &lp, const Path &p) {
@@ -28,46 +69,456 @@ namespace db {
       if (f.fail()) {
 	lp.files.erase(p);
 	ERROR(Db, fmt("Failed opening file: %0", p.string()));
+	static std::ofstream failed;
+	failed.setstate(std::ios::failbit);
+	return failed;
       }
 
+      set_int64_enc(f, file_enc(lp.proc));
       return f;
     }
 
     return fnd->second;
   }
 
+  static bool swap_files(WriteLoop &lp, const std::vector<BasicTable *> &tables) {
+    for (auto t: tables) {
+      const Path &p(t->path);
+      const Path tmp_path(p.string() + ".tmp"), bak_path(p.string() + ".bak");
+      lp.files.erase(p);
+      
+      if (!path_exists(p)) {
+	std::ofstream(p.string(), std::ios::out | std::ios::binary | std::ios::app);
+      }
+      
+      std::error_code e;
+      std::experimental::filesystem::rename(p, bak_path, e);
+      if (!e) { std::experimental::filesystem::rename(tmp_path, p, e); }
+
+      if (e) {
+	log(lp.proc, "Failed renaming %0: %1", tmp_path.string(), e.message());
+	return false;
+      }
+    }
+
+    return true;
+  }
+
+  static void restore_files(WriteLoop &lp, const std::vector<BasicTable *> &tables) {
+    for (auto t: tables) {
+      const Path &p(t->path);
+      const Path bak_path(p.string() + ".bak");
+      remove_path(p.string() + ".tmp");
+      if (!path_exists(bak_path)) { continue; }
+      lp.files.erase(p);
+      std::error_code e;
+      std::experimental::filesystem::rename(bak_path, p, e);
+      
+      if (e) {
+	log(lp.proc, "Failed restoring %0: %1", p.string(), e.message());
+      }
+    }
+  }
+  
+  static int64_t flush_files(WriteLoop &lp,
+			     const std::set<Path> &dirty,
+			     bool sync,
+			     bool &ok) {
+    int64_t syncs(0);
+    
+    for (auto &p: dirty) {
+      auto &f(get_file(lp, p));
+      f.flush();
+      if (f.fail()) { ok = false; }
+      if (!sync) { continue; }
+      
+      if (sync_path(p)) {
+	syncs++;
+      } else {
+	ok = false;
+	ERROR(Db, fmt("Failed syncing file: %0", p.string()));
+      }
+    }
+
+    return syncs;
+  }
+  
+  static void run_compaction(WriteLoop *lp, Compaction *c) {
+    TRY(try_compact);
+    auto &tbl(c->table);
+    std::ifstream f(tbl.path.string(), std::ios::in | std::ios::binary);
+    Data buf(c->offset, 0);
+    f.read(reinterpret_cast<char *>(&buf[0]), buf.size());
+
+    if (f.gcount() == std::streamsize(buf.size())) {
+      SpanBuf span(&buf[0], buf.size());
+      std::istream in(&span);
+      set_int64_enc(in, file_enc(lp->proc));
+      std::ofstream out(c->tmp_path.string(),
+			std::ios::out | std::ios::binary | std::ios::trunc);
+      c->live = tbl.compact(in, out);
+      out.close();
+      c->ok = !out.fail() && try_compact.errors.empty();
+    } else {
+      ERROR(Db, fmt("Failed reading file: %0", tbl.path.string()));
+    }
+    
+    c->done.store(true);
+    Msg msg(MSG_COMPACTED);
+    set(msg, Msg::SENDER, &tbl.ctx);
+    put(lp->inbox, msg, false);
+  }
+
+  static void start_compaction(WriteLoop &lp, BasicTable &tbl) {
+    auto &f(get_file(lp, tbl.path));
+    f.flush();
+    if (f.fail()) { return; }
+    
+    auto c(std::make_unique<Compaction>(tbl, path_size(tbl.path)));
+    c->thread = std::thread(run_compaction, &lp, c.get());
+    lp.compactions.emplace(tbl.path, std::move(c));
+  }
+
+  static bool append_tail(const Compaction &c) {
+    std::ifstream in(c.table.path.string(), std::ios::in | std::ios::binary);
+    in.seekg(c.offset);
+    std::ofstream out(c.tmp_path.string(),
+		      std::ios::out | std::ios::binary | std::ios::app);
+    out << in.rdbuf();
+    out.close();
+    return !out.fail();
+  }
+  
+  static void finish_compaction(WriteLoop &lp, const Path &p) {
+    auto fnd(lp.compactions.find(p));
+    auto &c(*fnd->second);
+    c.thread.join();
+    auto &f(get_file(lp, p));
+    f.flush();
+    bool ok(c.ok && !f.fail());
+    
+    if (ok && c.tail_entries) { ok = append_tail(c); }
+    if (ok && lp.sync.load() != SYNC_NONE) { ok = sync_path(c.tmp_path); }
+
+    if (!ok) {
+      log(lp.proc, "Failed compacting %0", p.string());
+      drop_compaction(lp, fnd);
+      return;
+    }
+
+    const uintmax_t old_size(path_size(p)), new_size(path_size(c.tmp_path));
+    lp.files.erase(p);
+    std::error_code e;
+    std::experimental::filesystem::rename(c.tmp_path, p, e);
+
+    if (e) {
+      log(lp.proc, "Failed renaming %0: %1", c.tmp_path.string(), e.message());
+      drop_compaction(lp, fnd);
+      return;
+    }
+
+    if (lp.sync.load() != SYNC_NONE && !sync_dir(p)) {
+      log(lp.proc, "Failed syncing directory of %0", p.string());
+    }
+      
+    log(lp.proc, "Compacted %0 from %1 to %2 bytes",
+	p.filename().string(), old_size, new_size);
+    
+    {
+      std::unique_lock<std::mutex> lock(lp.stats_mutex);
+      auto &ts(lp.table_stats[p]);
+      ts.entries = c.live + c.tail_entries;
+      ts.tail = c.tail_entries;
+      ts.bytes = new_size;
+      ts.tail_bytes = old_size - c.offset;
+      lp.stats.compactions++;
+      lp.stats.compacted_bytes += old_size - new_size;
+    }
+    
+    lp.compactions.erase(fnd);
+  }
+
+  static void finish_compactions(WriteLoop &lp) {
+    std::vector<Path> done;
+    
+    for (auto &c: lp.compactions) {
+      if (c.second->done.load()) { done.push_back(c.first); }
+    }
+
+    for (auto &p: done) { finish_compaction(lp, p); }
+  }
+
+  static void check_compaction(WriteLoop &lp, const Path &p) {
+    if (lp.compactions.find(p) != lp.compactions.end()) { return; }
+    TableStats ts;
+    
+    {
+      std::unique_lock<std::mutex> lock(lp.stats_mutex);
+      ts = lp.table_stats[p];
+    }
+    
+    if (ts.table &&
+	ts.entries >= COMPACT_MIN_ENTRIES &&
+	ts.entries - ts.live > COMPACT_RATIO * ts.live &&
+	ts.tail_bytes > COMPACT_RATIO * (ts.bytes - ts.tail_bytes)) {
+      start_compaction(lp, *ts.table);
+    }
+  }
+  
+  struct Chunk {
+    TmpBuf tmp;
+    std::ostream out;
+    Chunk(): tmp(crypt::Secret::NONCE_SIZE), out(&tmp.buf) { }
+  };
+  
+  static void write_batch(WriteLoop &lp, const std::vector<Msg> &batch) {
+    SyncPolicy sync(lp.sync.load());
+    std::set<Path> dirty;
+    std::map<Path, TableStats> deltas;
+    int64_t syncs(0);
+    bool ok(true);
+
+    if (sync == SYNC_NONE &&
+	std::any_of(batch.begin(), batch.end(),
+		    [](auto &msg) { return find(msg, Msg::ACK); })) {
+      sync = SYNC_BATCH;
+    }
+    
+    for (auto &msg: batch) {
+      std::map<Path, Chunk> chunks;
+      
+      for (auto &c: get(msg, Msg::CHANGES)) {
+	auto &tbl(c->basic_table());
+	auto &p(tbl.path);
+	auto &f(get_file(lp, p));
+
+	if (f.fail()) {
+	  ok = false;
+	} else {
+	  auto &d(deltas[p]);
+	  d.table = &tbl;
+	  d.entries++;
+	  d.live += c->live_delta();
+
+	  if (tbl.ctx.secret && cols_written(f)) {
+	    auto fnd(chunks.find(p));
+	    
+	    if (fnd == chunks.end()) {
+	      fnd = chunks.emplace(std::piecewise_construct,
+				   std::forward_as_tuple(p),
+				   std::forward_as_tuple()).first;
+	      auto &out(fnd->second.out);
+	      set_int64_enc(out, get_int64_enc(f));
+	      set_cols_written(out, true);
+	      set_chunked(out, true);
+	    }
+
+	    c->write(fnd->second.out);
+	  } else {
+	    const auto start(f.tellp());
+	    c->write(f);
+	    dirty.insert(p);
+	    d.bytes += f.tellp() - start;
+	  }
+	}
+      }
+
+      for (auto &c: chunks) {
+	auto &d(deltas[c.first]);
+	auto &f(get_file(lp, c.first));
+	const auto start(f.tellp());
+	write_chunk(*d.table, c.second.tmp.buf, f);
+	dirty.insert(c.first);
+	d.bytes += f.tellp() - start;
+      }
+
+      if (sync == SYNC_ALWAYS) {
+	syncs += flush_files(lp, dirty, true, ok);
+	dirty.clear();
+      }
+    }
+    
+    syncs += flush_files(lp, dirty, sync == SYNC_BATCH, ok);
+
+    for (auto &msg: batch) {
+      auto ack(find(msg, Msg::ACK));
+      if (ack) { (*ack)->set_value(ok); }
+    }
+
+    for (auto &d: deltas) {
+      auto fnd(lp.compactions.find(d.first));
+      if (fnd != lp.compactions.end()) { fnd->second->tail_entries += d.second.entries; }
+    }
+    
+    const int64_t done_at(usecs(pnow().time_since_epoch()));
+    std::unique_lock<std::mutex> lock(lp.stats_mutex);
+
+    for (auto &d: deltas) {
+      auto &ts(lp.table_stats[d.first]);
+      lp.owners[d.first][&d.second.table->ctx] = d.second.table;
+      if (!ts.table) { ts.table = d.second.table; }
+      ts.entries += d.second.entries;
+      ts.tail += d.second.entries;
+      ts.bytes += d.second.bytes;
+      ts.tail_bytes += d.second.bytes;
+      lp.stats.written_bytes += d.second.bytes;
+      ts.live = std::max(ts.live + d.second.live, int64_t(0));
+    }
+    
+    auto &s(lp.stats);
+    s.batches++;
+    s.syncs += syncs;
+    s.max_batch = std::max(s.max_batch, int64_t(batch.size()));
+    
+    for (auto &msg: batch) {
+      s.commits++;
+      auto posted_at(find(msg, Msg::POSTED_AT));
+      if (!posted_at) { continue; }
+      const int64_t lat(done_at - *posted_at);
+      s.total_usecs += lat;
+      s.max_usecs = std::max(s.max_usecs, lat);
+    }
+  }
+  
+  static void commit_batch(WriteLoop &lp, const std::vector<Msg> &batch) {
+    finish_compactions(lp);
+    write_batch(lp, batch);
+    std::set<Path> paths;
+    
+    for (auto &msg: batch) {
+      for (auto &c: get(msg, Msg::CHANGES)) { paths.insert(c->basic_table().path); }
+    }
+
+    for (auto &p: paths) { check_compaction(lp, p); }
+  }
+  
   void WriteLoop::on_msg(const Msg &msg) {
     auto ctx(get(msg, Msg::SENDER));
 
     switch (msg.type) {
     case MSG_COMMIT: { 
-      std::set<std::ofstream *> dirty;
+      std::vector<Msg> batch {msg};
 
-      for (auto &c: get(msg, Msg::CHANGES)) {
-	auto &f(get_file(*this, c->table_path()));
+      while (true) {
+	auto next(get(inbox, false));
+	if (!next) { break; }
+	
+	if (next->type != MSG_COMMIT) {
+	  commit_batch(*this, batch);
+	  on_msg(*next);
+	  return;
+	}
+	
+	batch.push_back(*next);
+      }
+
+      commit_batch(*this, batch);
+      break;
+    }
+    case MSG_CHECKPOINT: {
+      std::vector<BasicTable *> tables;
 
-	if (!f.fail()) {
-	  c->write(f);
-	  dirty.insert(&f);
+      {
+	std::unique_lock<std::mutex> lock(stats_mutex);
+      
+	for (auto &ts: table_stats) {
+	  auto &s(ts.second);
+	  
+	  if (s.table &&
+	      s.tail >= std::max(CHECKPOINT_MIN_TAIL, s.live / CHECKPOINT_TAIL_DIV) &&
+	      compactions.find(ts.first) == compactions.end()) {
+	    tables.push_back(s.table);
+	  }
 	}
       }
 
-      for (auto f: dirty) { f->flush(); }
+      for (auto t: tables) { start_compaction(*this, *t); }
+      break;
+    }
+    case MSG_COMPACTED:
+      finish_compactions(*this);
+      break;
+    case MSG_DISCONNECT: {
+      std::vector<Path> done;
+    
+      for (auto &c: compactions) {
+	if (&c.second->table.ctx == ctx) { done.push_back(c.first); }
+      }
+
+      for (auto &p: done) { finish_compaction(*this, p); }
+
+      {
+	std::unique_lock<std::mutex> lock(stats_mutex);
+	
+	for (auto &o: owners) {
+	  auto fnd(o.second.find(ctx));
+	  if (fnd == o.second.end()) { continue; }
+	  auto tbl(fnd->second);
+	  o.second.erase(fnd);
+	  auto &ts(table_stats[o.first]);
+	  
+	  if (ts.table == tbl) {
+	    ts.table = o.second.empty() ? nullptr : o.second.begin()->second;
+	  }
+	}
+      }
+      
+      put(ctx->inbox, Msg(MSG_OK));
       break;
     }
     case MSG_REWRITE: {
-      int64_t reclaimed(0); 
+      std::vector<BasicTable *> tables;
+      bool ok(true);
       
       for (auto t: ctx->tables) {
-	auto &f(get_file(*this, t.second->path));
-	auto old_size(f.tellp());
-	f.close();
-	f.open(t.second->path.string(), 
-	       std::ios::out | std::ios::binary | std::ios::trunc);
-	t.second->dump(f);
-	reclaimed += old_size-f.tellp();
+	auto &tbl(*t.second);
+	cancel_compaction(*this, tbl.path);
+	auto &f(get_file(*this, tbl.path));
+	f.flush();
+	const Path tmp_path(tbl.path.string() + ".tmp");
+	std::ofstream out(tmp_path.string(),
+			  std::ios::out | std::ios::binary | std::ios::trunc);
+	tbl.dump(out);
+	out.close();
+	tables.push_back(&tbl);
+	
+	if (out.fail() || (sync.load() != SYNC_NONE && !sync_path(tmp_path))) {
+	  log(proc, "Failed rewriting %0", tbl.path.string());
+	  ok = false;
+	  break;
+	}
       }
 
+      if (!ok) {
+	for (auto t: tables) { remove_path(t->path.string() + ".tmp"); }
+	put(ctx->inbox, Msg(MSG_ERROR));
+	break;
+      }
+      
+      for (auto t: tables) { remove_path(t->path.string() + ".bak"); }
+      
+      if (!swap_files(*this, tables) ||
+	  (sync.load() != SYNC_NONE && !sync_dir(proc.path / "rev")) ||
+	  (proc.rev.load() < DB_REV && !write_rev(proc, DB_REV))) {
+	restore_files(*this, tables);
+	put(ctx->inbox, Msg(MSG_ERROR));
+	break;
+      }
+      
+      int64_t reclaimed(0); 
+
+      for (auto t: tables) {
+	auto &tbl(*t);
+	const Path bak_path(tbl.path.string() + ".bak");
+	reclaimed += path_size(bak_path) - path_size(tbl.path);
+	remove_path(bak_path);
+	TableStats ts;
+	ts.entries = ts.live = tbl.size();
+	ts.bytes = path_size(tbl.path);
+	init_stats(*this, tbl, ts);
+      }
+
+      proc.rev.store(DB_REV);
       Msg msg(MSG_OK);
       set(msg, Msg::RECLAIMED, reclaimed);
       put(ctx->inbox, msg);
@@ -77,4 +528,27 @@ namespace db {
       log(proc, "Unsupported message type: %0", msg.type);
     }
   }
+
+  void set_sync(WriteLoop &lp, SyncPolicy sync) {
+    lp.sync.store(sync);
+  }
+  
+  WriteStats get_stats(WriteLoop &lp) {
+    std::unique_lock<std::mutex> lock(lp.stats_mutex);
+    return lp.stats;
+  }
+
+  void init_stats(WriteLoop &lp, BasicTable &tbl, const TableStats &stats) {
+    std::unique_lock<std::mutex> lock(lp.stats_mutex);
+    auto &ts(lp.table_stats[tbl.path]);
+    ts = stats;
+    ts.table = &tbl;
+    lp.owners[tbl.path][&tbl.ctx] = &tbl;
+  }
+
+  TableStats get_stats(WriteLoop &lp, const Path &p) {
+    std::unique_lock<std::mutex> lock(lp.stats_mutex);
+    auto fnd(lp.table_stats.find(p));
+    return (fnd == lp.table_stats.end()) ? TableStats() : fnd->second;
+  }
 }}
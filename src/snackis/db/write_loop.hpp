@@ -1,23 +1,73 @@
 #ifndef SNACKIS_DB_WRITE_LOOP_HPP
 #define SNACKIS_DB_WRITE_LOOP_HPP
 
+#include <atomic>
 #include <fstream>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 #include "snackis/core/path.hpp"
 #include "snackis/db/loop.hpp"
 
 namespace snackis {
 namespace db {
+  struct BasicTable;
+  struct Ctx;
   struct Proc;
+
+  enum SyncPolicy {SYNC_NONE, SYNC_BATCH, SYNC_ALWAYS};
+
+  const int64_t COMPACT_MIN_ENTRIES(1000);
+  const int64_t COMPACT_RATIO(2);
+  const int64_t CHECKPOINT_MIN_TAIL(1000);
+  const int64_t CHECKPOINT_TAIL_DIV(4);
+  
+  struct WriteStats {
+    int64_t commits, batches, syncs, max_batch, total_usecs, max_usecs;
+    int64_t compactions, compacted_bytes, written_bytes;
+    WriteStats();
+  };
+
+  struct TableStats {
+    BasicTable *table;
+    int64_t entries, live, tail, bytes, tail_bytes, packed_bytes, unpacked_bytes;
+    TableStats();
+  };
+
+  struct Compaction {
+    BasicTable &table;
+    const Path tmp_path;
+    const uintmax_t offset;
+    int64_t tail_entries, live;
+    bool ok;
+    std::atomic<bool> done;
+    std::thread thread;
+
+    Compaction(BasicTable &tbl, uintmax_t offset);
+  };
   
   struct WriteLoop: Loop {
+    using Compactions = std::map<Path, std::unique_ptr<Compaction>>;
+    
     std::map<Path, std::ofstream> files;
+    std::atomic<SyncPolicy> sync;
+    Compactions compactions;
+    WriteStats stats;
+    std::map<Path, TableStats> table_stats;
+    std::map<Path, std::map<const Ctx *, BasicTable *>> owners;
+    std::mutex stats_mutex;
     
     WriteLoop(Proc &p, size_t max_buf);
     ~WriteLoop();
     void on_msg(const Msg &msg) override;
   };
+
+  void set_sync(WriteLoop &lp, SyncPolicy sync);
+  WriteStats get_stats(WriteLoop &lp);
+  void init_stats(WriteLoop &lp, BasicTable &tbl, const TableStats &stats);
+  TableStats get_stats(WriteLoop &lp, const Path &p);
 }}
 
 #endif
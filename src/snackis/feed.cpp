@@ -69,22 +69,11 @@ namespace snackis {
 						const Time &end,
 						size_t max) {
     Ctx &ctx(fd.ctx);
-    auto &tbl(ctx.db.feed_posts);
     std::vector<const db::Rec<Post> *> out;
-    if (tbl.recs.empty()) { return out; }
-    
-    auto fnd(tbl.recs.lower_bound(tbl.key(fd.id, end, null_uid)));
-    if (fnd == tbl.recs.begin()) { return out; }
-    fnd--;
-    
-    while (out.size() < max) {
-      if (*db::get(fnd->second, post_feed_id) != fd.id) { break; }
-      const db::Rec<Post> &rec(db::get(ctx.db.posts, fnd->second));
-      out.push_back(&rec);
-      if (fnd == tbl.recs.begin()) { break; }
-      fnd--;
-    }
-
+    auto cur(db::scan(ctx.db.feed_posts, db::prefix(fd.id)));
+    db::before(cur, db::prefix(fd.id, end));
+    db::limit(db::reverse(cur), max);
+    while (auto key = db::fetch(cur)) { out.push_back(key->second); }
     return out;
   }
 }
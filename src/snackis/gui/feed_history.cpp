@@ -7,21 +7,21 @@
 
 namespace snackis {
 namespace gui {
-  enum PostCol {COL_PTR=0, COL_BY, COL_BODY};
+  enum PostCol {COL_KEY=0, COL_BY, COL_BODY};
 
   static void on_activate(GtkTreeView *treeview,
 			  GtkTreePath *path,
 			  GtkTreeViewColumn *col,
 			  FeedHistory *w) {
-    auto ps_rec(get_sel_rec<Post>(GTK_TREE_VIEW(w->lst)));
-    CHECK(ps_rec, _);
+    auto ps_rec(get_sel_rec(GTK_TREE_VIEW(w->lst), w->ctx.db.posts));
+    if (!ps_rec) { return; }
     Post ps(w->ctx, *ps_rec);
     push_view(new PostView(ps));
   }
   
   FeedHistory::FeedHistory(Ctx &ctx):
     ctx(ctx),
-    store(gtk_tree_store_new(3, G_TYPE_POINTER,
+    store(gtk_tree_store_new(3, G_TYPE_STRING,
 			     G_TYPE_STRING,
 			     G_TYPE_STRING)),
     box(gtk_box_new(GTK_ORIENTATION_VERTICAL, 5)),
@@ -60,7 +60,7 @@ namespace gui {
 		     fmt(ps.created_at, "%a %b %d, %H:%M").c_str()));
     
     gtk_tree_store_set(w.store, &it,
-		       COL_PTR, rec,
+		       COL_KEY, to_str(ps.id).c_str(),
 		       COL_BY, by.c_str(),
 		       COL_BODY, ps.body.c_str(),
 		       -1);
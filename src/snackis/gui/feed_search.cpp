@@ -6,7 +6,7 @@
 
 namespace snackis {
 namespace gui {
-  enum FeedCol {COL_PTR=0, COL_ID, COL_CREATED, COL_OWNER, COL_TAGS,
+  enum FeedCol {COL_KEY=0, COL_ID, COL_CREATED, COL_OWNER, COL_TAGS,
 		COL_INFO};
 
   static void edit(Ctx &ctx, const db::Rec<Feed> &rec) {
@@ -17,8 +17,9 @@ namespace gui {
   FeedSearch::FeedSearch(Ctx &ctx):
     SearchView<Feed>(ctx,
 		     "Feed",
+		     ctx.db.feeds,
 		     gtk_list_store_new(6,
-					G_TYPE_POINTER,
+					G_TYPE_STRING,
 					G_TYPE_STRING,
 					G_TYPE_STRING,
 					G_TYPE_STRING,
@@ -38,6 +39,7 @@ namespace gui {
     gtk_container_add(GTK_CONTAINER(top_box), id_box);
 
     gtk_container_add(GTK_CONTAINER(id_box), new_label("Id"));
+    gtk_entry_set_placeholder_text(GTK_ENTRY(id_fld), "Prefix");
     gtk_container_add(GTK_CONTAINER(id_box), id_fld);
     gtk_widget_set_halign(active_fld, GTK_ALIGN_END);
     gtk_widget_set_valign(active_fld, GTK_ALIGN_END);
@@ -55,6 +57,7 @@ namespace gui {
     gtk_grid_attach(GTK_GRID(frm), tags_fld, 0, row+1, 1, 1);
 
     gtk_grid_attach(GTK_GRID(frm), new_label("Text"), 1, row, 1, 1);
+    gtk_entry_set_placeholder_text(GTK_ENTRY(text_fld), "Word prefixes");
     gtk_widget_set_hexpand(text_fld, true);
     gtk_grid_attach(GTK_GRID(frm), text_fld, 1, row+1, 1, 1);
 
@@ -72,65 +75,50 @@ namespace gui {
   }
 
   void FeedSearch::find() {
-    size_t cnt(0);
-    
     str id_sel(trim(gtk_entry_get_text(GTK_ENTRY(id_fld))));
     bool active_sel(gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(active_fld)));
     str tags_str(trim(gtk_entry_get_text(GTK_ENTRY(tags_fld))));
     std::set<str> tags_sel(word_set(tags_str));
     str text_sel(trim(gtk_entry_get_text(GTK_ENTRY(text_fld))));
-    auto &peer_sel(peer_fld.selected);
+    auto peer_sel(peer_fld.selected);
     
-    for (auto key = ctx.db.feeds_sort.recs.rbegin();
-	 key != ctx.db.feeds_sort.recs.rend();
-	 key++) {
-      auto &rec(db::get(ctx.db.feeds, key->second));
-      Feed feed(ctx, rec);
-
-      if (id_sel.empty() && !feed.visible) { continue; }
-
-      if (!id_sel.empty() && find_ci(id_str(feed), id_sel) == str::npos) {
-	continue;
-      }
-
-      if (feed.active != active_sel) { continue; }
-
-      if (!tags_sel.empty()) {
-	std::vector<str> diff;
-	std::set_difference(tags_sel.begin(), tags_sel.end(),
-			    feed.tags.begin(), feed.tags.end(),
-			    std::back_inserter(diff));
-	if (!diff.empty()) { continue; }
-      }
-      
-      if (!text_sel.empty() &&
-	  find_ci(feed.name, text_sel) == str::npos &&
-	  find_ci(feed.info, text_sel) == str::npos) {
-	continue;
-      }
-
-      if (peer_sel) {
-	if (feed.owner_id != peer_sel->id &&
-	    feed.peer_ids.find(peer_sel->id) == feed.peer_ids.end()) { continue; }
-      }      
-      
-      Peer own(get_peer_id(ctx, feed.owner_id));
-
-      GtkTreeIter iter;
-      gtk_list_store_append(store, &iter);
-      gtk_list_store_set(store, &iter,
-			 COL_PTR, &rec,
-			 COL_ID, id_str(feed).c_str(),
-			 COL_CREATED,
-			 fmt(feed.created_at, "%a %b %d, %H:%M").c_str(),
-			 COL_OWNER, own.name.c_str(),
-			 COL_TAGS,
-			 join(feed.tags.begin(), feed.tags.end(), '\n').c_str(),
-			 COL_INFO, trim(fmt("%0\n%1", feed.name, feed.info)).c_str(),
-			 -1);
-      cnt++;
+    db::Query<Feed, UId> qry(ctx.db.feeds);
+    db::limit(qry, SEARCH_PAGE);
+    db::id_prefix(qry, id_sel);
+    if (id_sel.empty()) { db::eq(qry, feed_visible, true); }
+    db::eq(qry, feed_active, active_sel);
+    db::tagged(qry, ctx.db.feeds_tags, tags_sel);
+    db::match(qry, ctx.db.feeds_text, text_sel);
+
+    if (peer_sel) {
+      db::filter(qry, [peer_id = peer_sel->id](auto &rec) {
+	  return db::field(rec, feed_owner_id) == peer_id ||
+	    db::field(rec, feed_peer_ids).count(peer_id);
+	});
     }
-
-    gtk_widget_grab_focus(cnt ? list : id_fld);
+    
+    auto add_feed([this](auto &rec) {
+	Feed feed(ctx, rec);
+	Peer own(get_peer_id(ctx, feed.owner_id));
+	GtkTreeIter iter;
+	gtk_list_store_append(store, &iter);
+	gtk_list_store_set(store, &iter,
+			   COL_KEY, to_str(feed.id).c_str(),
+			   COL_ID, id_str(feed).c_str(),
+			   COL_CREATED,
+			   fmt(feed.created_at, "%a %b %d, %H:%M").c_str(),
+			   COL_OWNER, own.name.c_str(),
+			   COL_TAGS,
+			   join(feed.tags.begin(), feed.tags.end(), '\n').c_str(),
+			   COL_INFO, trim(fmt("%0\n%1", feed.name, feed.info)).c_str(),
+			   -1);
+      });
+
+    opt<db::KeyIndex<Feed, Time, UId>::Key::Type> last;
+    
+    next_page = [this, qry, add_feed, last]() mutable {
+      auto cur(db::scan(ctx.db.feeds_sort));
+      return db::run(qry, ctx.db.feeds_sort, db::reverse(cur), last, add_feed);
+    };
   }
 }}
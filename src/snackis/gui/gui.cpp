@@ -34,6 +34,15 @@ namespace gui {
     gtk_text_buffer_set_text(buf, in.c_str(), in.size());
   }
 
+  opt<UId> get_id(GtkTreeModel *mod, GtkTreeIter &iter) {
+    gchar *id(nullptr);
+    gtk_tree_model_get(mod, &iter, 0, &id, -1);
+    if (!id) { return nullopt; }
+    auto out(parse_uid(id));
+    g_free(id);
+    return out;
+  }
+
   opt<GtkTreeIter> get_sel_iter(GtkTreeView *w) {
     GtkTreeSelection *sel(gtk_tree_view_get_selection(w));
     GtkTreeIter iter;
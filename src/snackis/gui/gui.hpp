@@ -4,7 +4,8 @@
 #include <gtk/gtk.h>
 #include "snackis/core/opt.hpp"
 #include "snackis/core/str.hpp"
-#include "snackis/db/rec.hpp"
+#include "snackis/core/uid.hpp"
+#include "snackis/db/table.hpp"
 #include "snackis/gui/console.hpp"
 #include "snackis/gui/inbox.hpp"
 #include "snackis/gui/login.hpp"
@@ -33,30 +34,31 @@ namespace gui {
   void set_str(GtkEntry *w, const str &in);
   void set_str(GtkTextView *w, const str &in);
 
+  opt<UId> get_id(GtkTreeModel *mod, GtkTreeIter &iter);
+
   template <typename RecT>
-  const db::Rec<RecT> *get_sel_rec(GtkComboBox *w) {
+  const db::Rec<RecT> *get_sel_rec(GtkComboBox *w, db::Table<RecT, UId> &tbl) {
     GtkTreeIter iter;
     if (!gtk_combo_box_get_active_iter(w, &iter)) { return nullptr; }
-    const db::Rec<RecT> *rec(nullptr);
-    GtkTreeModel *mod(gtk_combo_box_get_model(w));
-    gtk_tree_model_get(mod, &iter, 0, &rec, -1); 
-    return rec;
+    auto id(get_id(gtk_combo_box_get_model(w), iter));
+    return id ? db::find(tbl, *id) : nullptr;
   }
 
   opt<GtkTreeIter> get_sel_iter(GtkTreeView *w);
 
   template <typename RecT>
-  const db::Rec<RecT> *get_rec(GtkTreeView *w, GtkTreeIter &it) {
-    const db::Rec<RecT> *rec(nullptr);
-    gtk_tree_model_get(gtk_tree_view_get_model(w), &it, 0, &rec, -1);
-    return rec;
+  const db::Rec<RecT> *get_rec(GtkTreeView *w,
+			       GtkTreeIter &it,
+			       db::Table<RecT, UId> &tbl) {
+    auto id(get_id(gtk_tree_view_get_model(w), it));
+    return id ? db::find(tbl, *id) : nullptr;
   }
 
   template <typename RecT>
-  const db::Rec<RecT> *get_sel_rec(GtkTreeView *w) {
+  const db::Rec<RecT> *get_sel_rec(GtkTreeView *w, db::Table<RecT, UId> &tbl) {
     auto iter(get_sel_iter(w));
     if (!iter) { return nullptr; }
-    return get_rec<RecT>(w, *iter);
+    return get_rec(w, *iter, tbl);
   }
 
   void each_sel(GtkTreeView *w, func<void (GtkTreeIter &)> fn);
@@ -12,7 +12,7 @@
 
 namespace snackis {
 namespace gui {
-  enum Cols { COL_PTR=0, COL_FROM, COL_INFO };
+  enum Cols { COL_KEY=0, COL_FROM, COL_INFO };
   
   static void on_sel_change(gpointer *_, Inbox *v) {
     gtk_widget_set_sensitive(v->dismiss_btn, sel_count(GTK_TREE_VIEW(v->lst)) > 0);
@@ -26,8 +26,8 @@ namespace gui {
     each_sel(GTK_TREE_VIEW(v->lst), [v](auto &it) {
 	TRY(try_dismiss);
 	db::Trans trans(v->ctx);
-	auto rec(get_rec<Msg>(GTK_TREE_VIEW(v->lst), it));
-	db::erase(v->ctx.db.inbox, *rec);
+	auto rec(get_rec(GTK_TREE_VIEW(v->lst), it, v->ctx.db.inbox));
+	if (rec) { db::erase(v->ctx.db.inbox, *rec); }
 	
 	if (try_dismiss.errors.empty()) {
 	  db::commit(trans, nullopt);
@@ -44,7 +44,8 @@ namespace gui {
 	Ctx &ctx(v->ctx);
 	db::Trans trans(ctx);
 	TRY(try_activate);
-	auto rec(get_rec<Msg>(GTK_TREE_VIEW(v->lst), it));
+	auto rec(get_rec(GTK_TREE_VIEW(v->lst), it, ctx.db.inbox));
+	if (!rec) { return; }
 	Msg msg(ctx, *rec);
 	
 	if (msg.type == Msg::INVITE) {
@@ -84,7 +85,7 @@ namespace gui {
   Inbox::Inbox(Ctx &ctx):
     View(ctx, "Inbox"),
     store(gtk_list_store_new(3,
-			     G_TYPE_POINTER,
+			     G_TYPE_STRING,
 			     G_TYPE_STRING, G_TYPE_STRING)),
     lst(new_tree_view(GTK_TREE_MODEL(store))),
     dismiss_btn(gtk_button_new_with_mnemonic("_Dismiss Selected")),
@@ -118,8 +119,10 @@ namespace gui {
     gtk_list_store_clear(store);
     size_t cnt(0);
     
-    for(const auto &key: ctx.db.inbox_sort.recs) {
-      auto &rec(db::get(ctx.db.inbox, key.second));
+    auto cur(db::scan(ctx.db.inbox_sort));
+
+    while (auto key = db::fetch(cur)) {
+      auto &rec(*key->second);
       Msg msg(ctx, rec);
 
       GtkTreeIter iter;
@@ -131,7 +134,7 @@ namespace gui {
 			 msg.from.c_str()));
 		    
       gtk_list_store_set(store, &iter,
-			 COL_PTR, &rec,
+			 COL_KEY, to_str(msg.id).c_str(),
 			 COL_FROM, from.c_str(),
 			 -1);
       
@@ -24,7 +24,12 @@ namespace gui {
     Ctx &ctx(v->ctx);
     
     if (!reader) {
-      open(ctx);
+      if (!open(ctx)) {
+	log(ctx, "Failed opening database");
+	gtk_widget_grab_focus(v->pass);
+	return;
+      }
+      
       imap_worker.emplace(ctx);
       smtp_worker.emplace(ctx);
 
@@ -6,16 +6,16 @@
 
 namespace snackis {
 namespace gui {
-  enum PeerCol {COL_PTR=0, COL_ID, COL_NAME, COL_TAGS, COL_INFO};
+  enum PeerCol {COL_KEY=0, COL_ID, COL_NAME, COL_TAGS, COL_INFO};
 
   static void edit(Ctx &ctx, const db::Rec<Peer> &rec) {
     push_view(new PeerView(Peer(ctx, rec)));
   }  
 
   PeerSearch::PeerSearch(Ctx &ctx):
-    SearchView<Peer>(ctx, "Peer",
+    SearchView<Peer>(ctx, "Peer", ctx.db.peers,
 		     gtk_list_store_new(5,
-					G_TYPE_POINTER,
+					G_TYPE_STRING,
 					G_TYPE_STRING,
 					G_TYPE_STRING,
 					G_TYPE_STRING,
@@ -32,6 +32,7 @@ namespace gui {
     int row(0);
     
     gtk_grid_attach(GTK_GRID(box), new_label("Id"), 0, row, 1, 1);
+    gtk_entry_set_placeholder_text(GTK_ENTRY(id_fld), "Prefix");
     gtk_grid_attach(GTK_GRID(box), id_fld, 0, row+1, 1, 1);
     gtk_widget_set_halign(active_fld, GTK_ALIGN_END);
     gtk_grid_attach(GTK_GRID(box), active_fld, 1, row+1, 1, 1);
@@ -43,6 +44,7 @@ namespace gui {
     gtk_grid_attach(GTK_GRID(box), tags_fld, 0, row+1, 1, 1);
 
     gtk_grid_attach(GTK_GRID(box), new_label("Text"), 1, row, 1, 1);
+    gtk_entry_set_placeholder_text(GTK_ENTRY(text_fld), "Word prefixes");
     gtk_widget_set_hexpand(text_fld, true);
     gtk_grid_attach(GTK_GRID(box), text_fld, 1, row+1, 1, 1);
 
@@ -55,51 +57,38 @@ namespace gui {
   }
 
   void PeerSearch::find() {
-    size_t cnt(0);    
     str id_sel(trim(gtk_entry_get_text(GTK_ENTRY(id_fld))));
     bool active_sel(gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(active_fld)));
     str tags_str(get_str(GTK_ENTRY(tags_fld)));
     std::set<str> tags_sel(word_set(tags_str));
     str text_sel(trim(gtk_entry_get_text(GTK_ENTRY(text_fld))));
     
-    for (const auto &key: ctx.db.peers_sort.recs) {
-      auto &rec(db::get(ctx.db.peers, key.second));
-      Peer peer(ctx, rec);
-
-      if (!id_sel.empty() && find_ci(id_str(peer), id_sel) == str::npos) {
-	continue;
-      }
-
-      if (peer.active != active_sel) { continue; }
+    db::Query<Peer, UId> qry(ctx.db.peers);
+    db::limit(qry, SEARCH_PAGE);
+    db::id_prefix(qry, id_sel);
+    db::eq(qry, peer_active, active_sel);
+    db::tagged(qry, ctx.db.peers_tags, tags_sel);
+    db::match(qry, ctx.db.peers_text, text_sel);
 
-      if (!tags_sel.empty()) {
-	std::vector<str> diff;
-	std::set_difference(tags_sel.begin(), tags_sel.end(),
-			    peer.tags.begin(), peer.tags.end(),
-			    std::back_inserter(diff));
-	if (!diff.empty()) { continue; }
-      }
-      
-      if (!text_sel.empty() &&
-	  find_ci(peer.name, text_sel) == str::npos &&
-	  find_ci(peer.email, text_sel) == str::npos &&
-	  find_ci(peer.info, text_sel) == str::npos) {
-	continue;
-      }
+    auto add_peer([this](auto &rec) {
+	Peer peer(ctx, rec);
+	GtkTreeIter iter;
+	gtk_list_store_append(store, &iter);
+	gtk_list_store_set(store, &iter,
+			   COL_KEY, to_str(peer.id).c_str(),
+			   COL_ID, id_str(peer).c_str(),
+			   COL_NAME, fmt("%0\n%1", peer.name, peer.email).c_str(),
+			   COL_TAGS,
+			   join(peer.tags.begin(), peer.tags.end(), '\n').c_str(),
+			   COL_INFO, peer.info.c_str(),
+			   -1);
+      });
 
-      GtkTreeIter iter;
-      gtk_list_store_append(store, &iter);
-      gtk_list_store_set(store, &iter,
-			 COL_PTR, &rec,
-			 COL_ID, id_str(peer).c_str(),
-			 COL_NAME, fmt("%0\n%1", peer.name, peer.email).c_str(),
-			 COL_TAGS,
-			 join(peer.tags.begin(), peer.tags.end(), '\n').c_str(),
-			 COL_INFO, peer.info.c_str(),
-			 -1);
-      cnt++;
-    }
-
-    gtk_widget_grab_focus(cnt ? list : id_fld);
+    opt<db::KeyIndex<Peer, str, UId>::Key::Type> last;
+    
+    next_page = [this, qry, add_peer, last]() mutable {
+      auto cur(db::scan(ctx.db.peers_sort));
+      return db::run(qry, ctx.db.peers_sort, cur, last, add_peer);
+    };
   }
 }}
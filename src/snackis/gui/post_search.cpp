@@ -6,7 +6,7 @@
 
 namespace snackis {
 namespace gui {
-  enum PostCol {COL_PTR=0, COL_ID, COL_BY, COL_TAGS, COL_BODY};
+  enum PostCol {COL_KEY=0, COL_ID, COL_BY, COL_TAGS, COL_BODY};
   
   static void edit(Ctx &ctx, const db::Rec<Post> &rec) {
     Post post(ctx, rec);    
@@ -16,7 +16,8 @@ namespace gui {
   PostSearch::PostSearch(Ctx &ctx):
     SearchView<Post>(ctx,
 		     "Post",
-		     gtk_list_store_new(5, G_TYPE_POINTER,
+		     ctx.db.posts,
+		     gtk_list_store_new(5, G_TYPE_STRING,
 					G_TYPE_STRING,
 					G_TYPE_STRING,
 					G_TYPE_STRING,
@@ -36,6 +37,7 @@ namespace gui {
     
     gtk_grid_attach(GTK_GRID(frm), new_label("Id"), 0, row, 1, 1);
     gtk_widget_set_halign(id_fld, GTK_ALIGN_START);
+    gtk_entry_set_placeholder_text(GTK_ENTRY(id_fld), "Prefix");
     gtk_grid_attach(GTK_GRID(frm), id_fld, 0, row+1, 1, 1);
     
     GtkWidget *post_box(new_grid());
@@ -61,6 +63,7 @@ namespace gui {
     gtk_grid_attach(GTK_GRID(frm), tags_fld, 0, row+1, 1, 1);
 
     gtk_grid_attach(GTK_GRID(frm), new_label("Body"), 1, row, 1, 1);
+    gtk_entry_set_placeholder_text(GTK_ENTRY(body_fld), "Word prefixes");
     gtk_widget_set_hexpand(body_fld, true);
     gtk_grid_attach(GTK_GRID(frm), body_fld, 1, row+1, 1, 1);
 
@@ -80,8 +83,6 @@ namespace gui {
   }
 
   void PostSearch::find() {
-    size_t cnt(0);
-    
     str id_sel(trim(gtk_entry_get_text(GTK_ENTRY(id_fld))));
     str tags_str(trim(gtk_entry_get_text(GTK_ENTRY(tags_fld))));
     std::set<str> tags_sel(word_set(tags_str));
@@ -107,65 +108,57 @@ namespace gui {
     }
 
     auto me(whoamid(ctx));
+    db::Query<Post, UId> qry(ctx.db.posts);
+    db::limit(qry, SEARCH_PAGE);
+    db::id_prefix(qry, id_sel);
+    db::tagged(qry, ctx.db.posts_tags, tags_sel);
+    db::match(qry, ctx.db.posts_text, body_sel);
+
+    if (peer_sel) {
+      db::filter(qry, [peer_id = peer_sel->id, me](auto &rec) {
+	  auto own(db::field(rec, post_owner_id));
+	  return own == peer_id ||
+	    (own == me && db::field(rec, post_peer_ids).count(peer_id));
+	});
+    }
     
-    for (auto key = ctx.db.posts_sort.recs.rbegin();
-	 key != ctx.db.posts_sort.recs.rend();
-	 key++) {
-      auto &rec(db::get(ctx.db.posts, key->second));
-      Post post(ctx, rec);
-      Feed feed(get_feed_id(ctx, post.feed_id));
-
-      if (!id_sel.empty() && find_ci(id_str(post), id_sel) == str::npos) {
-	continue;
-      }
-
-      if (!tags_sel.empty()) {
-	std::vector<str> diff;
-	std::set_difference(tags_sel.begin(), tags_sel.end(),
-			    post.tags.begin(), post.tags.end(),
-			    std::back_inserter(diff));
-	if (!diff.empty()) { continue; }
-      }
-      
-      if (!body_sel.empty() && find_ci(post.body, body_sel) == str::npos) {
-	continue;
-      }
-
-      if (!min_time_str.empty() && post.created_at < *min_time_sel) {
-	continue;
-      }
-
-      if (!max_time_str.empty() && post.created_at > *max_time_sel) {
-	continue;
-      }
+    auto add_post([this](auto &rec) {
+	Post post(ctx, rec);
+	auto pr(get_peer_id(ctx, post.owner_id));
+	GtkTreeIter iter;
+	gtk_list_store_append(store, &iter);
+	const str by(trim(fmt("%0\n%1",
+			      pr.name,
+			      fmt(post.created_at, "%a %b %d, %H:%M").c_str())));
+	gtk_list_store_set(store, &iter,
+			   COL_KEY, to_str(post.id).c_str(),
+			   COL_ID, id_str(post).c_str(),
+			   COL_BY, by.c_str(),
+			   COL_TAGS,
+			   join(post.tags.begin(), post.tags.end(), '\n').c_str(),
+			   COL_BODY, post.body.c_str(),
+			   -1);
+      });
+
+    if (feed_sel) {
+      opt<db::KeyIndex<Post, UId, Time, UId>::Key::Type> last;
       
-      if (feed_sel && post.feed_id != feed_sel->id) { continue; }
-
-      if (peer_sel &&
-	  post.owner_id != peer_sel->id &&
-	  (post.owner_id != me ||
-	   post.peer_ids.find(peer_sel->id) == post.peer_ids.end())) {
-	continue;
-      }
+      next_page = [this, qry, add_post, feed_id = feed_sel->id,
+		   min_time_sel, max_time_sel, last]() mutable {
+	auto cur(db::scan(ctx.db.feed_posts, db::prefix(feed_id)));
+	if (min_time_sel) { db::from(cur, db::prefix(feed_id, *min_time_sel)); }
+	if (max_time_sel) { db::until(cur, db::prefix(feed_id, *max_time_sel)); }
+	return db::run(qry, ctx.db.feed_posts, db::reverse(cur), last, add_post);
+      };
+    } else {
+      opt<db::KeyIndex<Post, Time, UId>::Key::Type> last;
       
-      auto pr(get_peer_id(ctx, post.owner_id));
-      
-      GtkTreeIter iter;
-      gtk_list_store_append(store, &iter);
-      const str by(trim(fmt("%0\n%1",
-			    pr.name,
-			    fmt(post.created_at, "%a %b %d, %H:%M").c_str())));
-      gtk_list_store_set(store, &iter,
-			 COL_PTR, &rec,
-			 COL_ID, id_str(post).c_str(),
-			 COL_BY, by.c_str(),
-			 COL_TAGS,
-			 join(post.tags.begin(), post.tags.end(), '\n').c_str(),
-			 COL_BODY, post.body.c_str(),
-			 -1);
-      cnt++;
+      next_page = [this, qry, add_post, min_time_sel, max_time_sel, last]() mutable {
+	auto cur(db::scan(ctx.db.posts_sort));
+	if (min_time_sel) { db::from(cur, db::prefix(*min_time_sel)); }
+	if (max_time_sel) { db::until(cur, db::prefix(*max_time_sel)); }
+	return db::run(qry, ctx.db.posts_sort, db::reverse(cur), last, add_post);
+      };
     }
-
-    gtk_widget_grab_focus(cnt ? list : id_fld);
   }
 }}
@@ -6,7 +6,7 @@
 
 namespace snackis {
 namespace gui {
-  enum ProjectCol {COL_PTR=0, COL_ID, COL_CREATED, COL_OWNER, COL_TAGS, COL_INFO};
+  enum ProjectCol {COL_KEY=0, COL_ID, COL_CREATED, COL_OWNER, COL_TAGS, COL_INFO};
 
   static void edit(Ctx &ctx, const db::Rec<Project> &rec) {
     push_view(new ProjectView(Project(ctx, rec)));
@@ -15,8 +15,9 @@ namespace gui {
   ProjectSearch::ProjectSearch(Ctx &ctx):
     SearchView<Project>(ctx,
 		     "Project",
+		     ctx.db.projects,
 		     gtk_list_store_new(6,
-					G_TYPE_POINTER,
+					G_TYPE_STRING,
 					G_TYPE_STRING,
 					G_TYPE_STRING,
 					G_TYPE_STRING,
@@ -35,6 +36,7 @@ namespace gui {
     
     gtk_grid_attach(GTK_GRID(frm), new_label("Id"), 0, row, 1, 1);
     gtk_widget_set_halign(id_fld, GTK_ALIGN_START);
+    gtk_entry_set_placeholder_text(GTK_ENTRY(id_fld), "Prefix");
     gtk_grid_attach(GTK_GRID(frm), id_fld, 0, row+1, 1, 1);
     gtk_widget_set_halign(active_fld, GTK_ALIGN_END);
     gtk_grid_attach(GTK_GRID(frm), active_fld, 1, row+1, 1, 1);
@@ -46,6 +48,7 @@ namespace gui {
     gtk_grid_attach(GTK_GRID(frm), tags_fld, 0, row+1, 1, 1);
 
     gtk_grid_attach(GTK_GRID(frm), new_label("Text"), 1, row, 1, 1);
+    gtk_entry_set_placeholder_text(GTK_ENTRY(text_fld), "Word prefixes");
     gtk_widget_set_hexpand(text_fld, true);
     gtk_grid_attach(GTK_GRID(frm), text_fld, 1, row+1, 1, 1);
 
@@ -63,63 +66,50 @@ namespace gui {
   }
 
   void ProjectSearch::find() {
-    size_t cnt(0);
-    
     str id_sel(trim(gtk_entry_get_text(GTK_ENTRY(id_fld))));
     bool active_sel(gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(active_fld)));
     str tags_str(trim(gtk_entry_get_text(GTK_ENTRY(tags_fld))));
     std::set<str> tags_sel(word_set(tags_str));
     str text_sel(trim(gtk_entry_get_text(GTK_ENTRY(text_fld)))); 
-    auto &peer_sel(peer_fld.selected);
+    auto peer_sel(peer_fld.selected);
     
-    for (const auto &key: ctx.db.projects_sort.recs) {
-      auto &rec(db::get(ctx.db.projects, key.second));
-      Project project(ctx, rec);
-
-      if (!id_sel.empty() && find_ci(id_str(project), id_sel) == str::npos) {
-	continue;
-      }
-
-      if (project.active != active_sel) { continue; }
+    db::Query<Project, UId> qry(ctx.db.projects);
+    db::limit(qry, SEARCH_PAGE);
+    db::id_prefix(qry, id_sel);
+    db::eq(qry, project_active, active_sel);
+    db::tagged(qry, ctx.db.projects_tags, tags_sel);
+    db::match(qry, ctx.db.projects_text, text_sel);
 
-      if (!tags_sel.empty()) {
-	std::vector<str> diff;
-	std::set_difference(tags_sel.begin(), tags_sel.end(),
-			    project.tags.begin(), project.tags.end(),
-			    std::back_inserter(diff));
-	if (!diff.empty()) { continue; }
-      }
-      
-      if (!text_sel.empty() &&
-	  find_ci(project.name, text_sel) == str::npos &&
-	  find_ci(project.info, text_sel) == str::npos) {
-	continue;
-      }
-
-      if (peer_sel &&
-	  project.owner_id != peer_sel->id &&
-	  project.peer_ids.find(peer_sel->id) == project.peer_ids.end()) {
-	continue;
-      }
-      
-      Peer own(get_peer_id(ctx, project.owner_id));
-
-      GtkTreeIter iter;
-      gtk_list_store_append(store, &iter);
-      gtk_list_store_set(store, &iter,
-			 COL_PTR, &rec,
-			 COL_ID, id_str(project).c_str(),
-			 COL_CREATED,
-			 fmt(project.created_at, "%a %b %d, %H:%M").c_str(),
-			 COL_OWNER, own.name.c_str(),
-			 COL_TAGS,
-			 join(project.tags.begin(), project.tags.end(), '\n').c_str(),
-			 COL_INFO, trim(fmt("%0\n%1",
-					    project.name, project.info)).c_str(), 
-			 -1);
-      cnt++;
+    if (peer_sel) {
+      db::filter(qry, [peer_id = peer_sel->id](auto &rec) {
+	  return db::field(rec, project_owner_id) == peer_id ||
+	    db::field(rec, project_peer_ids).count(peer_id);
+	});
     }
 
-    gtk_widget_grab_focus(cnt ? list : id_fld);
+    auto add_project([this](auto &rec) {
+	Project project(ctx, rec);
+	Peer own(get_peer_id(ctx, project.owner_id));
+	GtkTreeIter iter;
+	gtk_list_store_append(store, &iter);
+	gtk_list_store_set(store, &iter,
+			   COL_KEY, to_str(project.id).c_str(),
+			   COL_ID, id_str(project).c_str(),
+			   COL_CREATED,
+			   fmt(project.created_at, "%a %b %d, %H:%M").c_str(),
+			   COL_OWNER, own.name.c_str(),
+			   COL_TAGS,
+			   join(project.tags.begin(), project.tags.end(), '\n').c_str(),
+			   COL_INFO, trim(fmt("%0\n%1",
+					      project.name, project.info)).c_str(), 
+			   -1);
+      });
+
+    opt<db::KeyIndex<Project, str, UId>::Key::Type> last;
+    
+    next_page = [this, qry, add_project, last]() mutable {
+      auto cur(db::scan(ctx.db.projects_sort));
+      return db::run(qry, ctx.db.projects_sort, cur, last, add_project);
+    };
   }
 }}
@@ -139,7 +139,7 @@ namespace gui {
     add_cmd(rdr, "inbox", {}, [&ctx](auto args) {
 	refresh(ctx);
 
-	if (ctx.db.inbox.recs.empty()) {
+	if (ctx.db.inbox.recs->empty()) {
 	  log(ctx, "Inbox is empty");
 	} else {
 	  if (!inbox) { inbox.reset(new Inbox(ctx)); }
@@ -177,7 +177,7 @@ namespace gui {
     init_search<ProjectSearch>(rdr, "project");
 
     add_cmd(rdr, "send", {}, [&ctx](auto args) {
-	if (ctx.db.outbox.recs.empty()) {
+	if (ctx.db.outbox.recs->empty()) {
 	  log(ctx, "Nothing to send");
 	} else {
 	  smtp_worker->go.notify_one();
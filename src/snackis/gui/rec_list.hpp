@@ -21,7 +21,7 @@ namespace gui {
     virtual SearchView<RecT> *search() const=0;
   };
 
-  enum RecListCol {COL_REC_PTR=0, COL_REC_ID, COL_REC_NAME};
+  enum RecListCol {COL_REC_KEY=0, COL_REC_ID, COL_REC_NAME};
 
   template <typename RecT>
   void on_add_rec(gpointer *_, RecList<RecT> *w) {
@@ -38,7 +38,7 @@ namespace gui {
 	GtkTreeIter it;    
 	gtk_list_store_append(w->store, &it);
 	gtk_list_store_set(w->store, &it,
-			   COL_REC_PTR, &rec,
+			   COL_REC_KEY, to_str(obj.id).c_str(),
 			   COL_REC_ID, id_str(obj).c_str(),
 			   COL_REC_NAME, obj.name.c_str(),
 			   -1);
@@ -55,10 +55,9 @@ namespace gui {
   template <typename RecT>
   void activate(RecList<RecT> *w) {
     each_sel(GTK_TREE_VIEW(w->list), [w](auto it) {
-	auto rec(get_rec<RecT>(GTK_TREE_VIEW(w->list), it));
-	CHECK(rec, _);
-	RecT obj(w->ctx, *rec);
-	w->ids.erase(obj.id);
+	auto id(get_id(gtk_tree_view_get_model(GTK_TREE_VIEW(w->list)), it));
+	CHECK(id, _);
+	w->ids.erase(*id);
 	gtk_list_store_remove(w->store, &it);
       });
   }
@@ -83,7 +82,7 @@ namespace gui {
 			 const str &lbl,
 			 std::set<UId> &ids):
     ctx(ctx),
-    store(gtk_list_store_new(3, G_TYPE_POINTER,
+    store(gtk_list_store_new(3, G_TYPE_STRING,
 			     G_TYPE_STRING,
 			     G_TYPE_STRING)),
     box(gtk_box_new(GTK_ORIENTATION_VERTICAL, 5)),
@@ -140,7 +139,7 @@ namespace gui {
 	GtkTreeIter iter;
 	gtk_list_store_append(w.store, &iter);
 	gtk_list_store_set(w.store, &iter,
-			   COL_REC_PTR, rec,
+			   COL_REC_KEY, to_str(obj.id).c_str(),
 			   COL_REC_ID, id_str(obj).c_str(),
 			   COL_REC_NAME, obj.name.c_str(),
 			   -1);
@@ -6,7 +6,7 @@
 
 namespace snackis {
 namespace gui {
-  enum ScriptCol {COL_PTR=0, COL_ID, COL_CREATED, COL_OWNER, COL_TAGS, COL_NAME};
+  enum ScriptCol {COL_KEY=0, COL_ID, COL_CREATED, COL_OWNER, COL_TAGS, COL_NAME};
 
   static void edit(Ctx &ctx, const db::Rec<Script> &rec) {
     push_view(new ScriptView(Script(ctx, rec)));
@@ -15,8 +15,9 @@ namespace gui {
   ScriptSearch::ScriptSearch(Ctx &ctx):
     SearchView<Script>(ctx,
 		     "Script",
+		     ctx.db.scripts,
 		     gtk_list_store_new(6,
-					G_TYPE_POINTER,
+					G_TYPE_STRING,
 					G_TYPE_STRING,
 					G_TYPE_STRING,
 					G_TYPE_STRING,
@@ -34,6 +35,7 @@ namespace gui {
     
     gtk_grid_attach(GTK_GRID(frm), new_label("Id"), 0, row, 1, 1);
     gtk_widget_set_halign(id_fld, GTK_ALIGN_START);
+    gtk_entry_set_placeholder_text(GTK_ENTRY(id_fld), "Prefix");
     gtk_grid_attach(GTK_GRID(frm), id_fld, 0, row+1, 1, 1);
     
     row += 2;
@@ -59,57 +61,47 @@ namespace gui {
   }
 
   void ScriptSearch::find() {
-    size_t cnt(0);
-    
     str id_sel(trim(gtk_entry_get_text(GTK_ENTRY(id_fld))));
     str tags_str(trim(gtk_entry_get_text(GTK_ENTRY(tags_fld))));
     std::set<str> tags_sel(word_set(tags_str));
     str code_sel(trim(gtk_entry_get_text(GTK_ENTRY(code_fld)))); 
-    auto &peer_sel(peer_fld.selected);
+    auto peer_sel(peer_fld.selected);
     
-    for (const auto &key: ctx.db.scripts_sort.recs) {
-      auto &rec(db::get(ctx.db.scripts, key.second));
-      Script script(ctx, rec);
-
-      if (!id_sel.empty() && find_ci(id_str(script), id_sel) == str::npos) {
-	continue;
-      }
-
-      if (!tags_sel.empty()) {
-	std::vector<str> diff;
-	std::set_difference(tags_sel.begin(), tags_sel.end(),
-			    script.tags.begin(), script.tags.end(),
-			    std::back_inserter(diff));
-	if (!diff.empty()) { continue; }
-      }
-      
-      if (!code_sel.empty() && find_ci(script.code, code_sel) == str::npos) {
-	continue;
-      }
+    db::Query<Script, UId> qry(ctx.db.scripts);
+    db::limit(qry, SEARCH_PAGE);
+    db::id_prefix(qry, id_sel);
+    db::tagged(qry, ctx.db.scripts_tags, tags_sel);
+    db::contains(qry, script_code, code_sel);
 
-      if (peer_sel &&
-	  script.owner_id != peer_sel->id &&
-	  script.peer_ids.find(peer_sel->id) == script.peer_ids.end()) {
-	continue;
-      }
-      
-      Peer own(get_peer_id(ctx, script.owner_id));
-
-      GtkTreeIter iter;
-      gtk_list_store_append(store, &iter);
-      gtk_list_store_set(store, &iter,
-			 COL_PTR, &rec,
-			 COL_ID, id_str(script).c_str(),
-			 COL_CREATED,
-			 fmt(script.created_at, "%a %b %d, %H:%M").c_str(),
-			 COL_OWNER, own.name.c_str(),
-			 COL_TAGS,
-			 join(script.tags.begin(), script.tags.end(), '\n').c_str(),
-			 COL_NAME, script.name.c_str(), 
-			 -1);
-      cnt++;
+    if (peer_sel) {
+      db::filter(qry, [peer_id = peer_sel->id](auto &rec) {
+	  return db::field(rec, script_owner_id) == peer_id ||
+	    db::field(rec, script_peer_ids).count(peer_id);
+	});
     }
+    
+    auto add_script([this](auto &rec) {
+	Script script(ctx, rec);
+	Peer own(get_peer_id(ctx, script.owner_id));
+	GtkTreeIter iter;
+	gtk_list_store_append(store, &iter);
+	gtk_list_store_set(store, &iter,
+			   COL_KEY, to_str(script.id).c_str(),
+			   COL_ID, id_str(script).c_str(),
+			   COL_CREATED,
+			   fmt(script.created_at, "%a %b %d, %H:%M").c_str(),
+			   COL_OWNER, own.name.c_str(),
+			   COL_TAGS,
+			   join(script.tags.begin(), script.tags.end(), '\n').c_str(),
+			   COL_NAME, script.name.c_str(), 
+			   -1);
+      });
 
-    gtk_widget_grab_focus(cnt ? list : id_fld);
+    opt<db::KeyIndex<Script, str, Time, UId>::Key::Type> last;
+    
+    next_page = [this, qry, add_script, last]() mutable {
+      auto cur(db::scan(ctx.db.scripts_sort));
+      return db::run(qry, ctx.db.scripts_sort, cur, last, add_script);
+    };
   }
 }}
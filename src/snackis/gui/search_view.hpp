@@ -8,27 +8,53 @@
 
 namespace snackis {
 namespace gui {
+  const size_t SEARCH_PAGE(100);
+  
   template <typename RecT>
   struct SearchView: View {
     using OnActivate = func<void (const db::Rec<RecT> &)>;
+    using Page = func<size_t ()>;
+    db::Table<RecT, UId> &table;
     GtkListStore *store;
-    GtkWidget *fields, *find_btn, *list, *cancel_btn;
+    GtkWidget *fields, *find_btn, *list, *more_btn, *cancel_btn;
     OnActivate on_activate;
     bool close_on_activate;
+    Page next_page;
     
-    SearchView(Ctx &ctx, const str &type, GtkListStore *store, OnActivate act);
+    SearchView(Ctx &ctx,
+	       const str &type,
+	       db::Table<RecT, UId> &table,
+	       GtkListStore *store,
+	       OnActivate act);
     virtual void find()=0;
   };
 
   template <typename RecT>
-  size_t find(SearchView<RecT> &v) {
+  size_t find_more(SearchView<RecT> &v) {
     TRY(try_find);
+    const size_t prev(gtk_tree_model_iter_n_children(GTK_TREE_MODEL(v.store), nullptr));
+    const size_t cnt(v.next_page ? v.next_page() : 0);
+    gtk_widget_set_sensitive(v.more_btn, cnt == SEARCH_PAGE);
+    return prev + cnt;
+  }
+
+  template <typename RecT>
+  size_t find(SearchView<RecT> &v) {
     gtk_list_store_clear(v.store);
     refresh(v.ctx);
+    v.next_page = nullptr;
     v.find();
-
-    auto cnt(gtk_tree_model_iter_n_children(GTK_TREE_MODEL(v.store), nullptr));
-    if (cnt) { sel_first(GTK_TREE_VIEW(v.list)); }
+    if (!v.next_page) { return 0; }
+    
+    auto cnt(find_more(v));
+    
+    if (cnt) {
+      sel_first(GTK_TREE_VIEW(v.list));
+      gtk_widget_grab_focus(v.list);
+    } else {
+      gtk_widget_grab_focus(v.focused);
+    }
+    
     return cnt;
   }
   
@@ -37,14 +63,18 @@ namespace gui {
     find(*v);
   }
 
+  template <typename RecT>
+  void on_search_more(gpointer *_, SearchView<RecT> *v) {
+    find_more(*v);
+  }
+
   template <typename RecT>
   void activate(SearchView<RecT> *v) {
     TRY(try_activate);
 
     each_sel(GTK_TREE_VIEW(v->list), [v](auto it) {
-	auto rec(get_rec<RecT>(GTK_TREE_VIEW(v->list), it));
-	CHECK(rec, _);
-	v->on_activate(*rec);
+	auto rec(get_rec(GTK_TREE_VIEW(v->list), it, v->table));
+	if (rec) { v->on_activate(*rec); }
       });
     
     if (v->close_on_activate) {
@@ -77,13 +107,16 @@ namespace gui {
   template <typename RecT>
   SearchView<RecT>::SearchView(Ctx &ctx,
 			       const str &type,
+			       db::Table<RecT, UId> &table,
 			       GtkListStore *store,
 			       OnActivate act):
     View(ctx, fmt("%0 Search", type)),
+    table(table),
     store(store),
     fields(gtk_box_new(GTK_ORIENTATION_VERTICAL, 5)),
     find_btn(gtk_button_new_with_mnemonic(fmt("_Find %0s", type).c_str())),
     list(new_tree_view(GTK_TREE_MODEL(store))),
+    more_btn(gtk_button_new_with_mnemonic("Load _More")),
     cancel_btn(gtk_button_new_with_mnemonic("_Cancel")),
     on_activate(act),
     close_on_activate(false)
@@ -115,6 +148,10 @@ namespace gui {
     gtk_widget_set_valign(btns, GTK_ALIGN_END);
     gtk_widget_set_margin_top(btns, 10);
     gtk_container_add(GTK_CONTAINER(panel), btns);
+
+    g_signal_connect(more_btn, "clicked", G_CALLBACK(on_search_more<RecT>), this);
+    gtk_widget_set_sensitive(more_btn, false);
+    gtk_container_add(GTK_CONTAINER(btns), more_btn);
         
     g_signal_connect(cancel_btn, "clicked", G_CALLBACK(on_search_cancel<RecT>), this);
     gtk_container_add(GTK_CONTAINER(btns), cancel_btn);
@@ -129,7 +166,7 @@ namespace gui {
       return nullptr;
     }
     
-    return gui::get_rec<RecT>(GTK_TREE_VIEW(v.list), it);
+    return gui::get_rec(GTK_TREE_VIEW(v.list), it, v.table);
   }
 }}
 
@@ -133,6 +133,10 @@ namespace gui {
     set_val(ctx.settings.save_folder,
 	    str(gtk_entry_get_text(GTK_ENTRY(v->save_folder))));
 
+    auto sync(db::SyncPolicy(gtk_combo_box_get_active(GTK_COMBO_BOX(v->sync))));
+    set_val(ctx.settings.db_sync, int64_t(sync));
+    set_sync(ctx.proc.write_loop, sync);
+
     copy_flds(v->imap);
     if (*get_val(ctx.settings.imap.poll)) {
       imap_worker->go.notify_one();
@@ -219,6 +223,15 @@ namespace gui {
     auto sf(init_folder(v, v.save_folder, G_CALLBACK(on_sfolder), "Save"));
     gtk_widget_set_margin_top(sf, 10);
     gtk_grid_attach(GTK_GRID(frm), sf, 1, row, 1, 1);
+
+    row++;
+    lbl = new_label("Sync Database");
+    gtk_widget_set_margin_top(lbl, 10);
+    gtk_grid_attach(GTK_GRID(frm), lbl, 0, row, 1, 1);
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(v.sync), "Never");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(v.sync), "Once per Batch");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(v.sync), "After every Commit");
+    gtk_grid_attach(GTK_GRID(frm), v.sync, 0, row+1, 1, 1);
     
     return frm;
   }
@@ -231,6 +244,7 @@ namespace gui {
     pass_repeat(gtk_entry_new()),
     load_folder(gtk_entry_new()),
     save_folder(gtk_entry_new()),
+    sync(gtk_combo_box_text_new()),
     save(gtk_button_new_with_mnemonic("_Save Setup")),
     cancel(gtk_button_new_with_mnemonic("_Cancel")),
     imap(ctx, ctx.settings.imap, G_CALLBACK(on_imap)),
@@ -279,6 +293,7 @@ namespace gui {
 
     set_str(GTK_ENTRY(load_folder), *get_val(ctx.settings.load_folder));    
     set_str(GTK_ENTRY(save_folder), *get_val(ctx.settings.save_folder));
+    gtk_combo_box_set_active(GTK_COMBO_BOX(sync), *get_val(ctx.settings.db_sync));
 
     load_flds(imap);
     load_flds(smtp);
@@ -20,6 +20,7 @@ namespace gui {
     GtkWidget *name, *email,
       *pass, *pass_repeat,
       *load_folder, *save_folder,
+      *sync,
       *save, *cancel;
     Server imap, smtp;
     
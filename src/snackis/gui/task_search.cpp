@@ -6,7 +6,7 @@
 
 namespace snackis {
 namespace gui {
-  enum TaskCol {COL_PTR=0, COL_ID, COL_CREATED, COL_OWNER, COL_PRIO,
+  enum TaskCol {COL_KEY=0, COL_ID, COL_CREATED, COL_OWNER, COL_PRIO,
 		COL_TAGS, COL_INFO};
 
   static void edit(Ctx &ctx, const db::Rec<Task> &rec) {
@@ -16,7 +16,8 @@ namespace gui {
   TaskSearch::TaskSearch(Ctx &ctx):
     SearchView<Task>(ctx,
 		     "Task",
-		     gtk_list_store_new(7, G_TYPE_POINTER,
+		     ctx.db.tasks,
+		     gtk_list_store_new(7, G_TYPE_STRING,
 					G_TYPE_STRING,
 					G_TYPE_STRING,
 					G_TYPE_STRING,
@@ -39,6 +40,7 @@ namespace gui {
     
     gtk_grid_attach(GTK_GRID(frm), new_label("Id"), 0, row, 2, 1);
     gtk_widget_set_halign(id_fld, GTK_ALIGN_START);
+    gtk_entry_set_placeholder_text(GTK_ENTRY(id_fld), "Prefix");
     gtk_grid_attach(GTK_GRID(frm), id_fld, 0, row+1, 2, 1);
 
     gtk_grid_attach(GTK_GRID(frm), new_label("Prio"), 2, 0, 1, 1);
@@ -55,6 +57,7 @@ namespace gui {
     gtk_grid_attach(GTK_GRID(frm), tags_fld, 0, row+1, 2, 1);
 
     gtk_grid_attach(GTK_GRID(frm), new_label("Text"), 2, row, 2, 1);
+    gtk_entry_set_placeholder_text(GTK_ENTRY(text_fld), "Word prefixes");
     gtk_widget_set_hexpand(text_fld, true);
     gtk_grid_attach(GTK_GRID(frm), text_fld, 2, row+1, 2, 1);
 
@@ -75,8 +78,6 @@ namespace gui {
   }
 
   void TaskSearch::find() {
-    size_t cnt(0);    
-
     str id_sel(get_str(GTK_ENTRY(id_fld)));
     str prio_str(get_str(GTK_ENTRY(prio_fld)));
     int64_t prio_sel(to_int64(prio_str));
@@ -84,54 +85,44 @@ namespace gui {
     str tags_str(get_str(GTK_ENTRY(tags_fld)));
     std::set<str> tags_sel(word_set(tags_str));
     str text_sel(get_str(GTK_ENTRY(text_fld)));
+    auto project_sel(project_fld.selected);
     auto peer_sel(peer_fld.selected);
     
-    for (const auto &key: ctx.db.tasks_sort.recs) {
-      auto &rec(db::get(ctx.db.tasks, key.second));
-      Task tsk(ctx, rec);
-      
-      if (!id_sel.empty() && find_ci(id_str(tsk), id_sel) == str::npos) { continue; }
-
-      if (!tags_sel.empty()) {
-	std::vector<str> diff;
-	std::set_difference(tags_sel.begin(), tags_sel.end(),
-			    tsk.tags.begin(), tsk.tags.end(),
-			    std::back_inserter(diff));
-	if (!diff.empty()) { continue; }
-      }
-      
-      if (!text_sel.empty() &&
-	  find_ci(tsk.name, text_sel) == str::npos &&
-	  find_ci(tsk.info, text_sel) == str::npos) { continue; }
-      
-      if (!prio_str.empty() && prio_sel && tsk.prio > prio_sel) { continue; }
+    db::Query<Task, UId> qry(ctx.db.tasks);
+    db::limit(qry, SEARCH_PAGE);
+    db::id_prefix(qry, id_sel);
+    db::eq(qry, task_done, done_sel);
+    db::tagged(qry, ctx.db.tasks_tags, tags_sel);
+    db::match(qry, ctx.db.tasks_text, text_sel);
+    if (project_sel) { db::eq(qry, task_project_id, project_sel->id); }
+    if (peer_sel) { db::eq(qry, task_owner_id, peer_sel->id); }
+    
+    auto add_task([this](auto &rec) {
+	Task tsk(ctx, rec);
+	Project prj(get_project_id(ctx, tsk.project_id));
+	Peer own(get_peer_id(ctx, tsk.owner_id));
+	GtkTreeIter iter;
+	gtk_list_store_append(store, &iter);
+	gtk_list_store_set(store, &iter,
+			   COL_KEY, to_str(tsk.id).c_str(),
+			   COL_ID, id_str(tsk).c_str(),
+			   COL_CREATED,
+			   fmt(tsk.created_at, "%a %b %d, %H:%M").c_str(),
+			   COL_OWNER, own.name.c_str(),
+			   COL_PRIO, to_str(tsk.prio).c_str(),
+			   COL_TAGS,
+			   join(tsk.tags.begin(), tsk.tags.end(), '\n').c_str(),
+			   COL_INFO, trim(fmt("%0\n%1", tsk.name, tsk.info)).c_str(),
+			   -1);
+      });
 
-      if (tsk.done != done_sel) { continue; }
-      
-      auto project_sel(project_fld.selected);
-      if (project_sel && tsk.project_id != project_sel->id) { continue; }
-      
-      if (peer_sel && tsk.owner_id != peer_sel->id) { continue; }
-      
-      Project prj(get_project_id(ctx, tsk.project_id));
-      Peer own(get_peer_id(ctx, tsk.owner_id));
-      GtkTreeIter iter;
-      gtk_list_store_append(store, &iter);
-      gtk_list_store_set(store, &iter,
-			 COL_PTR, &rec,
-			 COL_ID, id_str(tsk).c_str(),
-			 COL_CREATED,
-			 fmt(tsk.created_at, "%a %b %d, %H:%M").c_str(),
-			 COL_OWNER, own.name.c_str(),
-			 COL_PRIO, to_str(tsk.prio).c_str(),
-			 COL_TAGS,
-			 join(tsk.tags.begin(), tsk.tags.end(), '\n').c_str(),
-			 COL_INFO, trim(fmt("%0\n%1", tsk.name, tsk.info)).c_str(),
-			 -1);
-      
-      cnt++;
-    }
+    const bool prio_max(!prio_str.empty() && prio_sel);
+    opt<db::KeyIndex<Task, int64_t, Time, UId>::Key::Type> last;
     
-    gtk_widget_grab_focus(cnt ? list : id_fld);
+    next_page = [this, qry, add_task, prio_max, prio_sel, last]() mutable {
+      auto cur(db::scan(ctx.db.tasks_sort));
+      if (prio_max) { db::until(cur, db::prefix(prio_sel)); }
+      return db::run(qry, ctx.db.tasks_sort, cur, last, add_task);
+    };
   }
 }}
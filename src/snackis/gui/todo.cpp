@@ -11,7 +11,7 @@
 
 namespace snackis {
 namespace gui {
-  enum Cols { COL_PTR=0, COL_INFO, COL_PRIO, COL_DONE };
+  enum Cols { COL_KEY=0, COL_INFO, COL_PRIO, COL_DONE };
   
   static void on_cancel(gpointer *_, Todo *v) {
     pop_view(v);
@@ -21,15 +21,15 @@ namespace gui {
 			  GtkTreePath *path,
 			  GtkTreeViewColumn *col,
 			  Todo *v) {
-    auto rec(get_sel_rec<Task>(tree));
-    CHECK(rec, _);
+    auto rec(get_sel_rec(tree, v->ctx.db.tasks));
+    if (!rec) { return; }
     push_view(new TaskView(Task(v->ctx, *rec)));
   }
   
   Todo::Todo(Ctx &ctx):
     View(ctx, "Todo"),
     store(gtk_list_store_new(4,
-			     G_TYPE_POINTER,
+			     G_TYPE_STRING,
 			     G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING)),
     lst(new_tree_view(GTK_TREE_MODEL(store))),
     cancel_btn(gtk_button_new_with_mnemonic("_Cancel"))
@@ -61,31 +61,27 @@ namespace gui {
     View::load();
     gtk_list_store_clear(store);
     refresh(ctx);
-    size_t cnt(0);
+    db::Query<Task, UId> qry(ctx.db.tasks);
+    db::tagged(qry, ctx.db.tasks_tags, {"todo"});
+    const Time done_min(now() - std::chrono::hours(TODO_DONE_DAYS*24));
     
-    for(const auto &key: ctx.db.tasks_sort.recs) {
-      auto &rec(db::get(ctx.db.tasks, key.second));
-      Task tsk(ctx, rec);
-      
-      if (tsk.tags.find("todo") == tsk.tags.end()) { continue; }
-
-      if (tsk.done &&
-	  tsk.done_at < now() - std::chrono::hours(TODO_DONE_DAYS*24)) {
-	continue;
-      }
-	
-      GtkTreeIter iter;
-      gtk_list_store_append(store, &iter);
-      Project prj(get_project_id(ctx, tsk.project_id));
+    db::filter(qry, [&done_min](auto &rec) {
+	return !db::field(rec, task_done) || !(db::field(rec, task_done_at) < done_min);
+      });
+    
+    size_t cnt(db::run(qry, ctx.db.tasks_sort, [&](auto &rec) {
+	Task tsk(ctx, rec);
+	GtkTreeIter iter;
+	gtk_list_store_append(store, &iter);
+	Project prj(get_project_id(ctx, tsk.project_id));
       
-      gtk_list_store_set(store, &iter,
-			 COL_PTR, &rec,
-			 COL_INFO, fmt("%0\n%1", prj.name, tsk.name).c_str(),
-			 COL_PRIO, to_str(tsk.prio).c_str(),
-			 COL_DONE, tsk.done ? "Done!" : "",
-			 -1);
-      cnt++;
-    }
+	gtk_list_store_set(store, &iter,
+			   COL_KEY, to_str(tsk.id).c_str(),
+			   COL_INFO, fmt("%0\n%1", prj.name, tsk.name).c_str(),
+			   COL_PRIO, to_str(tsk.prio).c_str(),
+			   COL_DONE, tsk.done ? "Done!" : "",
+			   -1);
+      }));
 
     if (cnt) {
       sel_first(GTK_TREE_VIEW(lst));
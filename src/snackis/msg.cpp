@@ -2,6 +2,7 @@
 #include "snackis/msg.hpp"
 #include "snackis/snackis.hpp"
 #include "snackis/core/bool_type.hpp"
+#include "snackis/core/buf.hpp"
 #include "snackis/core/int64_type.hpp"
 #include "snackis/core/time_type.hpp"
 #include "snackis/core/uid_type.hpp"
@@ -48,21 +49,12 @@ namespace snackis {
     Ctx &ctx(msg.ctx);
     const bool encrypt(msg.type != Msg::INVITE);
     
-    Stream buf;
+    TmpBuf tmp;
+    std::ostream buf(&tmp.buf);
     const db::Rec<Msg> rec(ctx.db.inbox, msg);
-    write(rec, buf, nullopt);
-    str data(buf.str());
-    
-    if (encrypt) {
-      Peer pr(get_peer_id(ctx, msg.to_id));
-      Data out(crypt::encrypt(*get_val(ctx.settings.crypt_key), pr.crypt_key,
-			      reinterpret_cast<const unsigned char *>(data.c_str()),
-			      data.size()));
-      data.assign(out.begin(), out.end());
-    }
-    
-    buf.str("");
+    set_int64_enc(buf, INT64_STR);
     int64_type.write(PROTO_REV, buf);
+    set_int64_enc(buf, INT64_VARINT);
     str_type.write(msg.type, buf);
 
     if (msg.type == Msg::ACCEPT) {
@@ -70,23 +62,34 @@ namespace snackis {
     } else if (encrypt) {
       uid_type.write(msg.from_id, buf);
     }
-   
-    buf << data;
-    data = buf.str();
+
+    if (encrypt) {
+      TmpBuf data;
+      std::ostream data_buf(&data.buf);
+      write(rec, data_buf, nullopt);
+      Peer pr(get_peer_id(ctx, msg.to_id));
+      const Data out(crypt::encrypt(*get_val(ctx.settings.crypt_key), pr.crypt_key,
+				    data.buf.begin(), data.buf.size()));
+      buf.write(reinterpret_cast<const char *>(&out[0]), out.size());
+    } else {
+      write(rec, buf, nullopt);
+    }
     
-    return bin_hex(reinterpret_cast<const unsigned char *>(data.c_str()),
-		   data.size());
+    return bin_hex(tmp.buf.begin(), tmp.buf.size());
   }
 
   bool decode(Msg &msg, const str &in) {
     TRACE("Decoding message");
     Ctx &ctx(msg.ctx);
     Data data(hex_bin(in));
-    InStream in_buf(str(data.begin(), data.end()));
-
+    SpanBuf span(data.data(), data.size());
+    std::istream in_buf(&span);
+    set_int64_enc(in_buf, INT64_STR);
     const int64_t proto_rev(int64_type.read(in_buf));
 
-    if (proto_rev != PROTO_REV) {
+    if (proto_rev == PROTO_REV) {
+      set_int64_enc(in_buf, INT64_VARINT);
+    } else if (proto_rev != PROTO_STR_REV) {
       log(msg.ctx, "Protocol revision mismatch");
       return false;
     }
@@ -104,11 +107,11 @@ namespace snackis {
 	msg.crypt_key = pr->crypt_key;
       }
       
-      data.erase(data.begin(), data.begin()+in_buf.tellg());
+      const size_t offs(in_buf.tellg());
       data = crypt::decrypt(*get_val(ctx.settings.crypt_key), msg.crypt_key,
-			    &data[0],
-			    data.size());
-      in_buf.str(str(data.begin(), data.end()));
+			    &data[offs],
+			    data.size()-offs);
+      span = SpanBuf(data.data(), data.size());
     }
 
     db::Rec<Msg> rec;
@@ -1,3 +1,4 @@
+#include <future>
 #include <iostream>
 #include <iterator>
 #include "snackis/ctx.hpp"
@@ -147,6 +148,8 @@ namespace net {
     int msg_cnt = 0;
     
     if (tokens.size() > 2) {
+      std::vector<std::pair<str, std::future<bool>>> acks;
+      
       for (auto tok = std::next(tokens.begin(), 2); tok != tokens.end(); tok++) {
 	db::Trans trans(ctx);
 	TRY(try_msg);
@@ -158,13 +161,22 @@ namespace net {
 	  receive(*msg);
 	  
 	  if (try_msg.errors.empty()) {
-	    db::commit(trans, nullopt);
-	    delete_uid(imap, uid);
-	    msg_cnt++;
+	    acks.emplace_back(uid, db::commit_durable(trans, nullopt));
 	  }
 	}
       }
 
+      for (auto &a: acks) {
+	if (!a.second.get()) {
+	  ERROR(Imap, fmt("Failed storing message, keeping uid: %0", a.first));
+	  continue;
+	}
+	
+	TRY(try_delete);
+	delete_uid(imap, a.first);
+	if (try_delete.errors.empty()) { msg_cnt++; }
+      }
+      
       if (msg_cnt) { expunge(imap); }
     }
 
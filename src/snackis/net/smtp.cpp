@@ -122,14 +122,14 @@ namespace net {
     Ctx &ctx(smtp.ctx);
     TRACE("Sending email");
     auto &tbl(ctx.db.outbox);
-    log(ctx, "Sending %0 messages...", tbl.recs.size());
+    log(ctx, "Sending %0 messages...", tbl.recs->size());
     
     while (true) {
       db::Trans trans(ctx);
-      if (tbl.recs.empty()) { break; }
+      if (tbl.recs->empty()) { break; }
       TRY(try_send);
 
-      auto i = tbl.recs.begin();
+      auto i = tbl.recs->begin();
       Msg msg(ctx, i->second);      
       send(smtp, msg);
       db::erase(tbl, i->first);
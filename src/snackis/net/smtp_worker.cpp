@@ -29,7 +29,7 @@ namespace net {
       if (!running) { break; }
 
       refresh(ctx);
-      if (!ctx.db.outbox.recs.empty()) {
+      if (!ctx.db.outbox.recs->empty()) {
 	Smtp smtp(ctx);
 	send(smtp);
       }
@@ -2,6 +2,7 @@
 #define SNACKIS_SETTING_HPP
 
 #include "snackis/rec.hpp"
+#include "snackis/core/int64_type.hpp"
 #include "snackis/core/opt.hpp"
 #include "snackis/core/str.hpp"
 #include "snackis/core/stream.hpp"
@@ -51,6 +52,15 @@ namespace snackis {
     stn.val = buf.str();
     upsert(stn.ctx.db.settings, dynamic_cast<BasicSetting &>(stn));
   }
+
+  template <typename ValT>
+  void upgrade(Setting<ValT> &stn) {
+    load(stn.ctx.db.settings, dynamic_cast<BasicSetting &>(stn));
+    if (stn.val.empty()) { return; }
+    Stream buf(stn.val);
+    set_int64_enc(buf, INT64_STR);
+    set_val(stn, stn.type.read(buf));
+  }
 }
 
 #endif
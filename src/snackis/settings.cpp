@@ -13,6 +13,14 @@ namespace snackis {
     pass(ctx, fmt("%0_pass", n), str_type,   str("")),
     poll(ctx, fmt("%0_poll", n), int64_type, 0)
   { }
+
+  void upgrade(ServerSettings &ss) {
+    upgrade(ss.url);
+    upgrade(ss.port);
+    upgrade(ss.user);
+    upgrade(ss.pass);
+    upgrade(ss.poll);
+  }
   
   Settings::Settings(Ctx &ctx):
     whoami(ctx,    "whoami",    uid_type),
@@ -20,7 +28,18 @@ namespace snackis {
 
     load_folder(ctx, "load_folder", str_type, str("load/")),
     save_folder(ctx, "save_folder", str_type, str("save/")),
+    db_sync(ctx, "db_sync", int64_type, db::SYNC_BATCH),
     imap(ctx, "imap", 993),
     smtp(ctx, "smtp", 587)
   { }
+
+  void upgrade(Settings &ss) {
+    upgrade(ss.whoami);
+    upgrade(ss.crypt_key);
+    upgrade(ss.load_folder);
+    upgrade(ss.save_folder);
+    upgrade(ss.db_sync);
+    upgrade(ss.imap);
+    upgrade(ss.smtp);
+  }
 }
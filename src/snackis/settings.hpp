@@ -13,14 +13,19 @@ namespace snackis {
     ServerSettings(Ctx &ctx, const str &n, int64_t port);
   };
 
+  void upgrade(ServerSettings &ss);
+
   struct Settings {
     Setting<UId> whoami;
     Setting<crypt::Key> crypt_key;
     Setting<str> load_folder, save_folder;
+    Setting<int64_t> db_sync;
     ServerSettings imap, smtp;
     
     Settings(Ctx &ctx);
   };
+
+  void upgrade(Settings &ss);
 }
 
 #endif
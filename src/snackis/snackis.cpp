@@ -7,8 +7,10 @@
 
 namespace snackis {
   const int VERSION[3] = {0, 9, 33};
-  const int64_t DB_REV = 3;
-  const int64_t PROTO_REV = 6;
+  const int64_t DB_REV = 9;
+  const int64_t DB_STR_REV = 3;
+  const int64_t PROTO_REV = 7;
+  const int64_t PROTO_STR_REV = 6;
 
   opt<net::ImapWorker> imap_worker;
   opt<net::SmtpWorker> smtp_worker;
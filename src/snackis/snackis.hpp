@@ -7,7 +7,7 @@
 
 namespace snackis {
   extern const int VERSION[3];
-  extern const int64_t DB_REV, PROTO_REV;
+  extern const int64_t DB_REV, DB_STR_REV, PROTO_REV, PROTO_STR_REV;
 
   extern opt<net::ImapWorker> imap_worker;
   extern opt<net::SmtpWorker> smtp_worker;
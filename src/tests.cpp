@@ -1,4 +1,10 @@
 #include <iostream>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <limits>
+#include <thread>
+#include <vector>
 
 #include "snackis/ctx.hpp"
 #include "snackis/snackis.hpp"
@@ -6,17 +12,23 @@
 #include "snackis/core/data.hpp"
 #include "snackis/core/bool_type.hpp"
 #include "snackis/core/int64_type.hpp"
+#include "snackis/core/path.hpp"
 #include "snackis/core/set_type.hpp"
 #include "snackis/core/str_type.hpp"
 #include "snackis/core/str.hpp"
 #include "snackis/core/stream.hpp"
 #include "snackis/core/time_type.hpp"
+#include "snackis/core/uid_map.hpp"
 #include "snackis/core/uid_type.hpp"
 #include "snackis/crypt/key.hpp"
 #include "snackis/crypt/secret.hpp"
 #include "snackis/db/col.hpp"
 #include "snackis/db/proc.hpp"
+#include "snackis/db/query.hpp"
 #include "snackis/db/table.hpp"
+#include "snackis/db/tag_index.hpp"
+#include "snackis/db/text_index.hpp"
+#include "snackis/db/write_loop.hpp"
 #include "snackis/net/imap.hpp"
 
 using namespace snackis;
@@ -149,7 +161,7 @@ static void table_slurp_tests() {
   commit(trans, nullopt);
 
   dump(tbl, buf);
-  tbl.recs.clear();
+  detach(tbl).clear();
   slurp(tbl, buf);
 
   CHECK(load(tbl, foo), _);
@@ -185,12 +197,617 @@ static void email_tests() {
   TRACE("Running email_tests");
   Proc proc("testdb/", MAX_BUF);
   snackis::Ctx ctx(proc, MAX_BUF);
-  ctx.db.inbox.recs.clear();
+  db::detach(ctx.db.inbox).clear();
   Imap imap(ctx);
   fetch(imap);
 }
 */
 
+const size_t TEST_BUF(32);
+
+static void int64_enc_tests() {
+  const std::vector<int64_t> vals({0, 1, -1, 63, -64, 64, -65, 300, -300,
+	std::numeric_limits<int64_t>::max(),
+	std::numeric_limits<int64_t>::min()});
+
+  for (auto enc: {INT64_VARINT, INT64_STR}) {
+    Stream buf;
+    set_int64_enc(buf, enc);
+    for (auto v: vals) { int64_type.write(v, buf); }
+    for (auto v: vals) { CHECK(int64_type.read(buf), _ == v); }
+  }
+
+  auto size([](int64_t val) {
+      Stream buf;
+      int64_type.write(val, buf);
+      return buf.str().size();
+    });
+
+  CHECK(size(0), _ == 1);
+  CHECK(size(-64), _ == 1);
+  CHECK(size(64), _ == 2);
+  CHECK(size(std::numeric_limits<int64_t>::min()), _ == 10);
+
+  InStream old(str("\x02" "42" "\x03" "-17", 7));
+  set_int64_enc(old, INT64_STR);
+  CHECK(int64_type.read(old), _ == 42);
+  CHECK(int64_type.read(old), _ == -17);
+}
+
+struct Bar {
+  UId id;
+  int64_t num;
+  str name, info;
+  std::set<str> tags;
+  Bar(): id(true), num(0) { }
+};
+
+static void table_cols_tests() {
+  Proc proc("testdb/", TEST_BUF);
+  db::Ctx ctx(proc, TEST_BUF);
+  Bar bar;
+  Stream buf;
+  
+  {
+    const Col<Bar, UId> id_col("id", uid_type, &Bar::id);
+    const Col<Bar, int64_t> num_col("num", int64_type, &Bar::num);
+    const Col<Bar, str> name_col("name", str_type, &Bar::name);
+    Table<Bar, UId> tbl(ctx, "cols_tests", make_key(id_col), {&num_col, &name_col});
+
+    Trans trans(ctx);
+    bar.num = 42;
+    bar.name = "foo";
+    CHECK(insert(tbl, bar), _);
+    tbl.dump(buf);
+
+    bar.name = "bar";
+    db::Rec<Bar> rec;
+    copy(tbl, rec, bar);
+    write(tbl, TABLE_UPDATE, rec, buf);
+    rollback(trans);
+  }
+
+  const Col<Bar, str> name_col("name", str_type, &Bar::name);
+  const Col<Bar, UId> id_col("id", uid_type, &Bar::id);
+  const Col<Bar, str> info_col("info", str_type, &Bar::info);
+  CHECK(name_col.ord, _ == 0);
+  Table<Bar, UId> tbl(ctx, "cols_tests", make_key(id_col), {&name_col, &info_col});
+  slurp(tbl, buf);
+  
+  auto rec(find(tbl, bar.id));
+  CHECK(rec != nullptr, _);
+  CHECK(*get(*rec, name_col), _ == "bar");
+  CHECK(!get(*rec, info_col), _);
+  CHECK(rec->size(), _ == 2);
+}
+
+static void table_blocks_tests() {
+  Proc proc("testdb/", TEST_BUF);
+  set_block_size(proc, 256);
+  db::Ctx ctx(proc, TEST_BUF);
+  ctx.secret.emplace();
+  crypt::init_salt(*ctx.secret);
+  crypt::init(*ctx.secret, "secret");
+  
+  const Col<Bar, UId> id_col("id", uid_type, &Bar::id);
+  const Col<Bar, int64_t> num_col("num", int64_type, &Bar::num);
+  const Col<Bar, str> name_col("name", str_type, &Bar::name);
+  Table<Bar, UId> tbl(ctx, "blocks_tests", make_key(id_col), {&num_col, &name_col});
+
+  Trans trans(ctx);
+  
+  for (int i(0); i < 100; i++) {
+    Bar bar;
+    bar.num = i;
+    bar.name = fmt("bar %0", i);
+    CHECK(insert(tbl, bar), _);
+  }
+
+  Stream buf;
+  tbl.dump(buf);
+  auto prev(tbl.recs);
+  auto stats(slurp(tbl, buf));
+  CHECK(stats.entries, _ == 100);
+  CHECK(stats.live, _ == 100);
+  CHECK(stats.packed_bytes, _ > 0);
+  CHECK(tbl.recs->size(), _ == prev->size());
+  
+  for (auto &r: *prev) {
+    auto rec(find(tbl, r.first));
+    CHECK(rec != nullptr, _);
+    CHECK(compare(tbl, *rec, r.second), _ == 0);
+  }
+  
+  rollback(trans);
+}
+
+static void table_compact_tests() {
+  remove_path("testdb/");
+  UId id;
+  int64_t prio(0);
+  
+  {
+    Proc proc("testdb/", TEST_BUF);
+    set_sync(proc.write_loop, SYNC_NONE);
+    snackis::Ctx ctx(proc, TEST_BUF);
+    init_pass(ctx, "secret");
+    CHECK(open(ctx), _);
+
+    auto set_prio([&ctx, &id, &prio](int64_t val) {
+	Trans trans(ctx);
+	Task tsk(get_task_id(ctx, id));
+	tsk.prio = prio = val;
+	update(ctx.db.tasks, tsk);
+	commit(trans, nullopt);
+      });
+    
+    {
+      Trans trans(ctx);
+      Task tsk(ctx);
+      id = tsk.id;
+      CHECK(insert(ctx.db.tasks, tsk), _);
+      commit(trans, nullopt);
+    }
+    
+    for (int64_t i(0);
+	 i < 10 * COMPACT_MIN_ENTRIES && !get_stats(proc.write_loop).compactions;
+	 i++) {
+      set_prio(i);
+    }
+
+    CHECK(get_stats(proc.write_loop).compactions, _ == 1);
+    for (int64_t i(0); i < 10; i++) { set_prio(-i); }
+    const Path p(ctx.db.tasks.path);
+    CHECK(!path_exists(p.string() + ".tmp"), _);
+    CHECK(get_stats(proc.write_loop, p).tail, _ < COMPACT_MIN_ENTRIES);
+  }
+
+  Proc proc("testdb/", TEST_BUF);
+  snackis::Ctx ctx(proc, TEST_BUF);
+  CHECK(login(ctx, "secret"), _);
+  CHECK(open(ctx), _);
+  CHECK(ctx.db.tasks.recs->size(), _ == 1);
+  CHECK(get_task_id(ctx, id).prio, _ == prio);
+}
+
+template <typename FnT>
+static bool await_refresh(db::Ctx &ctx, const FnT &fn) {
+  for (int i(0); i < 1000; i++) {
+    refresh(ctx);
+    if (fn()) { return true; }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  return false;
+}
+
+static void table_delta_tests() {
+  remove_path("testdb/");
+  UId id;
+  
+  {
+    Proc proc("testdb/", TEST_BUF);
+    snackis::Ctx foo(proc, TEST_BUF);
+    init_pass(foo, "secret");
+    CHECK(open(foo), _);
+    
+    snackis::Ctx bar(proc, TEST_BUF);
+    CHECK(login(bar, "secret"), _);
+    CHECK(open(bar), _);
+    
+    Task tsk(foo);
+    id = tsk.id;
+    tsk.name = "foo";
+    tsk.info = "bar";
+    
+    {
+      Trans trans(foo);
+      CHECK(insert(foo.db.tasks, tsk), _);
+      commit(trans, nullopt);
+    }
+    
+    CHECK(await_refresh(bar, [&]() { return find(bar.db.tasks, id); }), _);
+    
+    {
+      Trans trans(foo);
+      tsk.prio = 42;
+      update(foo.db.tasks, tsk);
+      commit(trans, nullopt);
+    }
+    
+    {
+      Trans trans(bar);
+      Task bar_tsk(get_task_id(bar, id));
+      CHECK(bar_tsk.prio, _ == 0);
+      bar_tsk.info = "baz";
+      update(bar.db.tasks, bar_tsk);
+      commit(trans, nullopt);
+    }
+    
+    CHECK(await_refresh(foo, [&]() {
+	  return get_task_id(foo, id).info == "baz";
+	}), _);
+    
+    CHECK(await_refresh(bar, [&]() {
+	  return get_task_id(bar, id).prio == 42;
+	}), _);
+    
+    for (auto ctx: {&foo, &bar}) {
+      Task t(get_task_id(*ctx, id));
+      CHECK(t.name, _ == "foo");
+      CHECK(t.info, _ == "baz");
+      CHECK(t.prio, _ == 42);
+    }
+  }
+
+  Proc proc("testdb/", TEST_BUF);
+  snackis::Ctx ctx(proc, TEST_BUF);
+  CHECK(login(ctx, "secret"), _);
+  CHECK(open(ctx), _);
+  Task t(get_task_id(ctx, id));
+  CHECK(t.name, _ == "foo");
+  CHECK(t.info, _ == "baz");
+  CHECK(t.prio, _ == 42);
+}
+
+static void rewrite_restore_tests() {
+  remove_path("testdb/");
+  UId id;
+  Path p;
+  
+  {
+    Proc proc("testdb/", TEST_BUF);
+    snackis::Ctx ctx(proc, TEST_BUF);
+    init_pass(ctx, "secret");
+    CHECK(open(ctx), _);
+    Trans trans(ctx);
+    Task tsk(ctx);
+    id = tsk.id;
+    CHECK(insert(ctx.db.tasks, tsk), _);
+    CHECK(commit_durable(trans, nullopt).get(), _);
+    rewrite(ctx);
+    p = ctx.db.tasks.path;
+  }
+
+  const Path bak_path(p.string() + ".bak");
+  CHECK(!path_exists(bak_path), _);
+  std::experimental::filesystem::copy_file(p, bak_path);
+  
+  {
+    Proc proc("testdb/", TEST_BUF);
+    CHECK(!path_exists(bak_path), _);
+  }
+
+  std::experimental::filesystem::rename(p, bak_path);
+  Proc proc("testdb/", TEST_BUF);
+  CHECK(path_exists(p), _);
+  CHECK(!path_exists(bak_path), _);
+  snackis::Ctx ctx(proc, TEST_BUF);
+  CHECK(login(ctx, "secret"), _);
+  CHECK(open(ctx), _);
+  CHECK(find(ctx.db.tasks, id) != nullptr, _);
+}
+
+static void table_chunk_tests() {
+  remove_path("testdb/");
+  Proc proc("testdb/", TEST_BUF);
+  snackis::Ctx ctx(proc, TEST_BUF);
+  init_pass(ctx, "secret");
+  CHECK(open(ctx), _);
+  std::vector<Task> tsks;
+  
+  {
+    Trans trans(ctx);
+    
+    for (int i(0); i < 10; i++) {
+      tsks.emplace_back(ctx);
+      tsks.back().name = fmt("task %0", i);
+      CHECK(insert(ctx.db.tasks, tsks.back()), _);
+    }
+    
+    commit(trans, nullopt);
+  }
+
+  {
+    Trans trans(ctx);
+    tsks[0].prio = 42;
+    update(ctx.db.tasks, tsks[0]);
+    erase(ctx.db.tasks, tsks[1]);
+    CHECK(commit_durable(trans, nullopt).get(), _);
+  }
+
+  std::ifstream in(ctx.db.tasks.path.string(), std::ios::in | std::ios::binary);
+  set_int64_enc(in, file_enc(proc));
+  Table<Task, UId>::Recs recs;
+  auto stats(slurp(ctx.db.tasks, in, recs));
+  CHECK(stats.tail, _ == 12);
+  CHECK(recs.size(), _ == 9);
+  CHECK(recs.find(ctx.db.tasks.key(tsks[1].id)) == recs.end(), _);
+  CHECK(*get(recs.find(ctx.db.tasks.key(tsks[0].id))->second, task_prio), _ == 42);
+}
+
+static void uid_prefix_tests() {
+  const UId id(true);
+  const str id_str(to_str(id));
+  
+  auto rng(parse_uid_prefix(id_str.substr(0, 9)));
+  CHECK(rng, _);
+  CHECK(!(id < rng->first) && !(rng->second < id), _);
+  CHECK(rng->first < rng->second, _);
+
+  rng = parse_uid_prefix(id_str);
+  CHECK(rng->first == id && rng->second == id, _);
+
+  rng = parse_uid_prefix("");
+  CHECK(rng->first == null_uid, _);
+  CHECK(parse_uid_prefix("A")->first == parse_uid_prefix("a")->first, _);
+  CHECK(!parse_uid_prefix("xyz"), _);
+  CHECK(!parse_uid_prefix("\xe9"), _);
+  CHECK(!parse_uid_prefix(id_str + "0"), _);
+
+  Proc proc("testdb/", TEST_BUF);
+  db::Ctx ctx(proc, TEST_BUF);
+  const Col<Bar, UId> id_col("id", uid_type, &Bar::id);
+  Table<Bar, UId> tbl(ctx, "uid_prefix_tests", make_key(id_col), {});
+  Trans trans(ctx);
+  Bar foo, bar;
+  CHECK(insert(tbl, foo), _);
+  CHECK(insert(tbl, bar), _);
+
+  auto hits([&tbl](const str &prefix) {
+      auto cur(scan_id(tbl, prefix));
+      size_t cnt(0);
+      while (fetch(cur)) { cnt++; }
+      return cnt;
+    });
+
+  CHECK(hits(""), _ == 2);
+  CHECK(hits(to_str(foo.id)), _ == 1);
+  CHECK(hits(to_str(foo.id).substr(0, 8)), _ == 1);
+  CHECK(hits("xyz"), _ == 0);
+
+  auto cur(scan_id(tbl, to_str(bar.id).substr(0, 8)));
+  CHECK(std::get<0>(fetch(cur)->first) == bar.id, _);
+  rollback(trans);
+}
+
+static void query_page_tests() {
+  Proc proc("testdb/", TEST_BUF);
+  db::Ctx ctx(proc, TEST_BUF);
+  const Col<Bar, UId> id_col("id", uid_type, &Bar::id);
+  const Col<Bar, int64_t> num_col("num", int64_type, &Bar::num);
+  Table<Bar, UId> tbl(ctx, "query_page_tests", make_key(id_col), {&num_col});
+  KeyIndex<Bar, int64_t, UId> idx(make_key(num_col, id_col));
+  tbl.indexes.insert(&idx);
+  
+  Trans trans(ctx);
+  Query<Bar, UId>::Keys some;
+  
+  for (int i(0); i < 100; i++) {
+    Bar bar;
+    bar.num = i % 10;
+    CHECK(insert(tbl, bar), _);
+    if (i < 20) { some.insert(tbl.key(bar.id)); }
+  }
+
+  auto pages([&](Query<Bar, UId> &qry, bool rev) {
+      opt<KeyIndex<Bar, int64_t, UId>::Key::Type> last;
+      std::vector<KeyIndex<Bar, int64_t, UId>::Key::Type> out;
+      size_t cnt(0);
+      
+      do {
+	auto cur(scan(idx));
+	from(cur, prefix(int64_t(2)));
+	if (rev) { reverse(cur); }
+	
+	cnt = run(qry, idx, cur, last, [&](auto &rec) {
+	    out.push_back(idx.key(rec));
+	  });
+
+	CHECK(cnt, _ <= qry.max);
+      } while (cnt == qry.max);
+
+      for (size_t i(1); i < out.size(); i++) {
+	CHECK(rev ? out[i] < out[i-1] : out[i-1] < out[i], _);
+      }
+
+      return out.size();
+    });
+  
+  for (auto rev: {false, true}) {
+    Query<Bar, UId> qry(tbl);
+    limit(qry, 7);
+    filter(qry, [&num_col](auto &rec) { return field(rec, num_col) % 2; });
+    CHECK(pages(qry, rev), _ == 40);
+
+    narrow(qry, Query<Bar, UId>::Keys(some));
+    CHECK(pages(qry, rev), _ == 8);
+  }
+
+  rollback(trans);
+}
+
+static void text_index_tests() {
+  Proc proc("testdb/", TEST_BUF);
+  db::Ctx ctx(proc, TEST_BUF);
+  const Col<Bar, UId> id_col("id", uid_type, &Bar::id);
+  const Col<Bar, str> name_col("name", str_type, &Bar::name);
+  Table<Bar, UId> tbl(ctx, "text_index_tests", make_key(id_col), {&name_col});
+  TextIndex<Bar, UId> idx(make_key(id_col), {&name_col});
+  tbl.indexes.insert(&idx);
+  
+  Trans trans(ctx);
+  Bar foo, bar, baz;
+  foo.name = "Apple pie";
+  bar.name = "apples, pears";
+  baz.name = "Banana split";
+  for (auto b: {&foo, &bar, &baz}) { CHECK(insert(tbl, *b), _); }
+
+  CHECK(find_prefix(idx, "app").size(), _ == 2);
+  CHECK(find_prefix(idx, "apples").size(), _ == 1);
+  CHECK(find_prefix(idx, "pi").size(), _ == 1);
+  CHECK(find_prefix(idx, "ple").empty(), _);
+
+  std::deque<TextIndex<Bar, UId>::Keys> buf;
+  CHECK(find_prefix(idx, "pie", buf) == &idx.words.find("pie")->second, _);
+  CHECK(buf.empty(), _);
+  CHECK(find_prefix(idx, "zzz", buf) == nullptr, _);
+
+  CHECK(find(idx, "APP pea").size(), _ == 1);
+  CHECK(*find(idx, "APP pea").begin() == tbl.key(bar.id), _);
+  CHECK(find(idx, "ban app").empty(), _);
+  CHECK(find(idx, "").empty(), _);
+
+  CHECK(erase(tbl, baz), _);
+  CHECK(find_prefix(idx, "b").empty(), _);
+  CHECK(idx.words.find("banana") == idx.words.end(), _);
+  rollback(trans);
+}
+
+static void tag_index_tests() {
+  Proc proc("testdb/", TEST_BUF);
+  db::Ctx ctx(proc, TEST_BUF);
+  const Col<Bar, UId> id_col("id", uid_type, &Bar::id);
+  const Col<Bar, std::set<str>> tags_col("tags", str_set_type, &Bar::tags);
+  Table<Bar, UId> tbl(ctx, "tag_index_tests", make_key(id_col), {&tags_col});
+  TagIndex<Bar, UId> idx(make_key(id_col), tags_col);
+  tbl.indexes.insert(&idx);
+  
+  Trans trans(ctx);
+  Bar foo, bar, baz;
+  foo.tags = {"a", "b"};
+  bar.tags = {"b", "c"};
+  baz.tags = {"a", "b", "c"};
+  for (auto b: {&foo, &bar, &baz}) { CHECK(insert(tbl, *b), _); }
+  
+  CHECK(find(idx, std::set<str>{"b"}).size(), _ == 3);
+  CHECK(find(idx, std::set<str>{"a", "b"}).size(), _ == 2);
+  CHECK(find(idx, std::set<str>{"a", "x"}).empty(), _);
+
+  auto both(find(idx, std::set<str>{"a", "c"}));
+  CHECK(both.size(), _ == 1);
+  CHECK(*both.begin() == tbl.key(baz.id), _);
+
+  TagIndex<Bar, UId>::Keys xs, ys, zs;
+  for (int i(0); i < 100; i++) { xs.insert(tbl.key(UId(true))); }
+  ys.insert(xs.begin(), std::next(xs.begin(), 50));
+  zs.insert(std::next(xs.begin(), 40), std::next(xs.begin(), 60));
+  std::vector<const TagIndex<Bar, UId>::Keys *> in({&xs, &ys, &zs});
+  auto out(intersect(in));
+  CHECK(out.size(), _ == 10);
+  CHECK(*out.begin() == *std::next(xs.begin(), 40), _);
+  CHECK(in.front() == &zs, _);
+  
+  std::vector<TagIndex<Bar, UId>::Keys> one({xs});
+  CHECK(intersect(one) == xs, _);
+  rollback(trans);
+}
+
+static void uid_map_tests() {
+  UIdMap<int> m;
+  std::vector<UId> ids;
+  CHECK(find(m, UId(true)) == nullptr, _);
+  
+  for (int i(0); i < 1000; i++) {
+    ids.emplace_back(true);
+    insert(m, ids.back(), i);
+  }
+
+  CHECK(m.used, _ == 1000);
+  CHECK(m.slots.size() & (m.slots.size()-1), _ == 0);
+  CHECK(m.slots.size(), _ >= 2000);
+  insert(m, ids[0], -1);
+  CHECK(m.used, _ == 1000);
+  CHECK(*find(m, ids[0]), _ == -1);
+
+  for (int i(0); i < 1000; i += 2) { CHECK(erase(m, ids[i]), _); }
+  CHECK(!erase(m, ids[0]), _);
+  CHECK(m.used, _ == 500);
+  CHECK(m.dead, _ == 500);
+  
+  for (int i(0); i < 1000; i++) {
+    auto v(find(m, ids[i]));
+    CHECK(i % 2 ? v && *v == i : !v, _);
+  }
+
+  for (int i(0); i < 10000; i++) {
+    const UId id(true);
+    insert(m, id, i);
+    CHECK(*find(m, id), _ == i);
+    CHECK(erase(m, id), _);
+  }
+
+  CHECK(m.used, _ == 500);
+  CHECK((m.used + m.dead) * 2, _ <= m.slots.size());
+  for (int i(1); i < 1000; i += 2) { CHECK(*find(m, ids[i]), _ == i); }
+  
+  clear(m);
+  CHECK(find(m, ids[1]) == nullptr, _);
+}
+
+static void table_detach_tests() {
+  remove_path("testdb/");
+  Proc proc("testdb/", TEST_BUF);
+  snackis::Ctx ctx(proc, TEST_BUF);
+  init_pass(ctx, "secret");
+  CHECK(open(ctx), _);
+
+  Trans trans(ctx);
+  Task foo(ctx), bar(ctx);
+  foo.name = "foo";
+  bar.name = "bar";
+  CHECK(insert(ctx.db.tasks, foo), _);
+  auto snap(ctx.db.tasks.recs);
+  CHECK(insert(ctx.db.tasks, bar), _);
+  CHECK(ctx.db.tasks.recs != snap, _);
+  CHECK(snap->size() + 1, _ == ctx.db.tasks.recs->size());
+
+  for (auto &i: ctx.db.tasks_sort.recs) {
+    CHECK(i.second, _ == &get(ctx.db.tasks, *i.second));
+  }
+
+  Query<Task, UId> qry(ctx.db.tasks);
+  match(qry, ctx.db.tasks_text, "foo");
+  CHECK(run(qry, ctx.db.tasks_sort, [](auto &rec) { }), _ == 1);
+  rollback(trans);
+}
+
+static void query_match_tests() {
+  remove_path("testdb/");
+  Proc proc("testdb/", TEST_BUF);
+  snackis::Ctx ctx(proc, TEST_BUF);
+  init_pass(ctx, "secret");
+  CHECK(open(ctx), _);
+
+  Trans trans(ctx);
+  Task foo(ctx), bar(ctx);
+  foo.name = "Apple pie";
+  bar.name = "Banana split";
+  bar.info = "with apples";
+  CHECK(insert(ctx.db.tasks, foo), _);
+  CHECK(insert(ctx.db.tasks, bar), _);
+
+  auto hits([&ctx](const str &id_sel, const str &text_sel) {
+      Query<Task, UId> qry(ctx.db.tasks);
+      id_prefix(qry, id_sel);
+      match(qry, ctx.db.tasks_text, text_sel);
+      return run(qry, ctx.db.tasks_sort, [](auto &rec) { });
+    });
+
+  CHECK(hits("", "app"), _ == 2);
+  CHECK(hits("", "PI app"), _ == 1);
+  CHECK(hits("", "ple"), _ == 0);
+  CHECK(hits("", "pie split"), _ == 0);
+  CHECK(hits("", "!!!"), _ == 2);
+
+  const str id(to_str(foo.id));
+  CHECK(hits(id, ""), _ == 1);
+  CHECK(hits(id.substr(0, 8), "apple"), _ == 1);
+  CHECK(hits(id.substr(0, 8), "banana"), _ == 0);
+  CHECK(hits(id.substr(1, 8), ""), _ == 0);
+  rollback(trans);
+}
+
 namespace snabel {
   void all_tests();
 }
@@ -209,6 +826,21 @@ int main() {
   table_slurp_tests();
   read_write_tests();
   email_tests();*/
+  init();
+  int64_enc_tests();
+  table_cols_tests();
+  table_blocks_tests();
+  table_compact_tests();
+  table_delta_tests();
+  table_chunk_tests();
+  rewrite_restore_tests();
+  uid_map_tests();
+  uid_prefix_tests();
+  query_page_tests();
+  text_index_tests();
+  tag_index_tests();
+  table_detach_tests();
+  query_match_tests();
   snabel::all_tests();
   return 0;
 }